@@ -1,11 +1,12 @@
 #include "application.h"
 
+#include <cstdlib>
+
 #include <QMetaObject>
 #include <QtDebug>
 
 #include "dove_eye/aggregator.h"
 #include "dove_eye/async_policy.h"
-#include "dove_eye/blocking_policy.h"
 #include "dove_eye/camera_calibration.h"
 #include "dove_eye/camera_video_provider.h"
 #include "dove_eye/chessboard_pattern.h"
@@ -13,6 +14,13 @@
 #include "dove_eye/frameset.h"
 #include "dove_eye/frameset_aggregator.h"
 #include "dove_eye/histogram_tracker.h"
+#include "dove_eye/klt_tracker.h"
+#include "dove_eye/location_publisher.h"
+#include "dove_eye/metrics.h"
+#include "dove_eye/motion_time_calibration.h"
+#include "dove_eye/mosse_tracker.h"
+#include "dove_eye/prefetch_policy.h"
+#include "dove_eye/recorder.h"
 #include "dove_eye/template_tracker.h"
 #include "dove_eye/tld_tracker.h"
 #include "dove_eye/tracker.h"
@@ -21,7 +29,6 @@
 
 using dove_eye::Aggregator;
 using dove_eye::AsyncPolicy;
-using dove_eye::BlockingPolicy;
 using dove_eye::CalibrationData;
 using dove_eye::CameraCalibration;
 using dove_eye::CameraIndex;
@@ -30,8 +37,15 @@ using dove_eye::ChessboardPattern;
 using dove_eye::CircleTracker;
 using dove_eye::Frameset;
 using dove_eye::HistogramTracker;
+using dove_eye::KltTracker;
 using dove_eye::Localization;
+using dove_eye::LocationPublisher;
+using dove_eye::Metrics;
+using dove_eye::MosseTracker;
+using dove_eye::MotionTimeCalibration;
 using dove_eye::Parameters;
+using dove_eye::PrefetchPolicy;
+using dove_eye::Recorder;
 using dove_eye::TemplateTracker;
 using dove_eye::Tracker;
 using std::unique_ptr;
@@ -44,9 +58,18 @@ Application::Application()
       controller_(nullptr),
       converter_(nullptr) {
   RegisterMetaTypes();
+
+  /* Metrics file for external scrapers (e.g. node exporter textfile) */
+  const char *metrics_file = std::getenv("DOVE_EYE_METRICS");
+  if (metrics_file) {
+    Metrics::Instance().StartDump(metrics_file,
+                                  parameters_.Get(Parameters::METRICS_INTERVAL));
+  }
 }
 
 Application::~Application() {
+  Metrics::Instance().StopDump();
+
   for (auto object : objects_in_threads_) {
     object->deleteLater();
   }
@@ -197,7 +220,7 @@ void Application::SetupController(const ProvidersType type,
           std::move(providers), parameters_);
       break;
     case kVideoFiles:
-      aggregator = new dove_eye::FramesetAggregator<BlockingPolicy>(
+      aggregator = new dove_eye::FramesetAggregator<PrefetchPolicy>(
           std::move(providers), parameters_);
       break;
     case kNoProviders:
@@ -215,12 +238,19 @@ void Application::SetupController(const ProvidersType type,
   //TemplateTracker inner_tracker(parameters_);
   //HistogramTracker inner_tracker(parameters_);
   //CircleTracker inner_tracker(parameters_);
+  //MosseTracker inner_tracker(parameters_);
+  //KltTracker inner_tracker(parameters_, TemplateTracker(parameters_));
   dove_eye::TldTracker inner_tracker(parameters_);
-  auto tracker = new Tracker(arity_, inner_tracker);
+  auto tracker = new Tracker(parameters_, arity_, inner_tracker);
   auto localization = new Localization(arity_);
+  auto time_calibration = new MotionTimeCalibration(parameters_, arity_);
+  auto recorder = new Recorder(parameters_, arity_);
+  auto publisher = new LocationPublisher(arity_);
 
   auto new_controller = new Controller(parameters_, aggregator, calibration,
-                                       tracker, localization);
+                                       tracker, localization,
+                                       time_calibration, recorder,
+                                       publisher);
   new_controller->SetTrackerMarkType(inner_tracker.PreferredMarkType());
 
   connect(new_controller, &Controller::CalibrationDataReady,
@@ -238,7 +268,7 @@ void Application::TeardownController() {
 void Application::SetupConverter() {
   assert(controller_);
 
-  auto new_converter = new FramesetConverter(arity_);
+  auto new_converter = new FramesetConverter(parameters_, arity_);
   SwapAndDestroy(&converter_, new_converter);
 
   QObject::connect(controller_, &Controller::FramesetReady,
@@ -1,6 +1,7 @@
 #include "controller.h"
 
 #include <cassert>
+#include <memory>
 
 #include <opencv2/opencv.hpp>
 #include <QTimerEvent>
@@ -11,6 +12,7 @@
 using dove_eye::CalibrationData;
 using dove_eye::CameraIndex;
 using dove_eye::Frameset;
+using dove_eye::FramesetPtr;
 using dove_eye::InnerTracker;
 using dove_eye::Location;
 using dove_eye::Parameters;
@@ -57,6 +59,22 @@ void Controller::Resume() {
   emit Started();
 }
 
+void Controller::Seek(const double timestamp) {
+  if (!frameset_iterator_.Seek(timestamp)) {
+    DEBUG("Providers cannot seek");
+    return;
+  }
+
+  if (!timer_.isActive()) {
+    /* Revive finished playback */
+    emit Paused();
+  }
+
+  if (frameset_iterator_ != frameset_end_iterator_) {
+    emit FramesetReady(std::make_shared<const Frameset>(*frameset_iterator_));
+  }
+}
+
 void Controller::SetMark(const dove_eye::CameraIndex cam,
                          const GuiMark gui_mark) {
   if (!calibration_data_) {
@@ -73,9 +91,15 @@ void Controller::SetMark(const dove_eye::CameraIndex cam,
     return;
   }
 
-  auto positset = tracker_->SetMark(*frameset_iterator_,
-                                    cam, mark, project_other);
-  FramesetLoopTracking(positset);
+  /* Mark is set on the frameset that is processed next */
+  if (recorder_->IsRecording()) {
+    recorder_->RecordMark(frameset_iterator_->sequence_no, cam, mark,
+                          project_other);
+  }
+
+  const auto &positset = tracker_->SetMark(*frameset_iterator_,
+                                           cam, mark, project_other);
+  FramesetLoopTracking(*frameset_iterator_, positset);
 }
 
 void Controller::SetMode(const Mode mode) {
@@ -122,6 +146,35 @@ void Controller::SetLocalizationActive(const bool value) {
   localization_active_ = value;
 }
 
+void Controller::SetFusedTracking(const bool value) {
+  tracker_->fused(value);
+}
+
+void Controller::SetTimeCalibrationActive(const bool value) {
+  if (value && !time_calibration_active_) {
+    time_calibration_->Reset();
+  }
+  time_calibration_active_ = value;
+}
+
+void Controller::StartRecording(const QString basename, const bool compress) {
+  auto codec = compress ? dove_eye::recording::kPng
+                        : dove_eye::recording::kRaw;
+  recorder_->Start(basename.toStdString(), codec);
+}
+
+void Controller::StopRecording() {
+  recorder_->Stop();
+}
+
+void Controller::SetPublishingActive(const bool value) {
+  if (value) {
+    publisher_->Open();
+  } else {
+    publisher_->Close();
+  }
+}
+
 void Controller::SetCalibrationData(const CalibrationData calibration_data) {
   /* Before we delete old calibration_data update references. */
   auto new_calibration_data = new CalibrationData(calibration_data);
@@ -155,7 +208,22 @@ bool Controller::FramesetLoop() {
     return false;
   }
 
-  auto frameset = *frameset_iterator_;
+  /* The only copy of iterator's frameset, it's shared with consumers. */
+  FramesetPtr frameset_ptr = std::make_shared<const Frameset>(
+      *frameset_iterator_);
+  const Frameset &frameset = *frameset_ptr;
+
+  /* Time offsets are estimated in background of any mode. */
+  if (time_calibration_active_) {
+    time_calibration_->MeasureFrameset(frameset);
+  }
+
+  if (recorder_->IsRecording()) {
+    for (CameraIndex cam = 0; cam < Arity(); ++cam) {
+      recorder_->RecordDropped(cam, aggregator_->Dropped(cam));
+    }
+    recorder_->Record(frameset);
+  }
 
   switch (mode_) {
     case kIdle:
@@ -182,7 +250,7 @@ bool Controller::FramesetLoop() {
 
       break;
     case kTracking: {
-      FramesetLoopTracking(tracker_->Track(frameset));
+      FramesetLoopTracking(frameset, tracker_->Track(frameset));
       break;
     }
     case kNonexistent:
@@ -191,26 +259,40 @@ bool Controller::FramesetLoop() {
   }
 
 
-  emit FramesetReady(*frameset_iterator_);
+  emit FramesetReady(frameset_ptr);
 
   ++frameset_iterator_;
   return true;
 }
 
-void Controller::FramesetLoopTracking(const dove_eye::Positset positset) {
+void Controller::FramesetLoopTracking(const dove_eye::Frameset &frameset,
+                                      const dove_eye::Positset &positset) {
   if (mode_ != kTracking && positset.ValidCount() > 0) {
     SetMode(kTracking);
   }
 
   emit PositsetReady(positset);
 
+  Location location;
+  bool location_valid = false;
   if (localization_active_) {
-    Location location;
     if (localization_->Locate(positset, &location)) {
       DEBUG("loc: %f %f %f", location.x, location.y, location.z);
       emit LocationReady(location);
+      location_valid = true;
+
+      /* Fused tracker keeps its own location estimate */
+      if (!tracker_->fused()) {
+        tracker_->SetLocation(location);
+      }
     }
   }
+
+  /* External consumers, never blocks */
+  if (publisher_->IsOpen()) {
+    publisher_->Publish(frameset, positset,
+                        location_valid ? &location : nullptr);
+  }
 }
 
 void Controller::CalibrationDataToProviders(
@@ -6,13 +6,17 @@
 #include <QBasicTimer>
 #include <QObject>
 #include <QPoint>
+#include <QString>
 
 #include "dove_eye/aggregator.h"
 #include "dove_eye/calibration_data.h"
 #include "dove_eye/camera_calibration.h"
 #include "dove_eye/inner_tracker.h"
 #include "dove_eye/localization.h"
+#include "dove_eye/location_publisher.h"
+#include "dove_eye/motion_time_calibration.h"
 #include "dove_eye/parameters.h"
+#include "dove_eye/recorder.h"
 #include "dove_eye/tracker.h"
 #include "dove_eye/types.h"
 #include "gui/gui_mark.h"
@@ -52,20 +56,27 @@ class Controller : public QObject {
              dove_eye::Aggregator *aggregator,
              dove_eye::CameraCalibration *calibration,
              dove_eye::Tracker *tracker,
-             dove_eye::Localization *localization)
+             dove_eye::Localization *localization,
+             dove_eye::MotionTimeCalibration *time_calibration,
+             dove_eye::Recorder *recorder,
+             dove_eye::LocationPublisher *publisher)
       : QObject(),
         parameters_(parameters),
         mode_(kIdle),
         undistort_mode_(kIgnoreDistortion),
         tracker_mark_type_(dove_eye::InnerTracker::Mark::kCircle),
         localization_active_(false),
+        time_calibration_active_(false),
         arity_(aggregator->Arity()),
         frameset_iterator_(aggregator->Arity()),
         frameset_end_iterator_(aggregator->Arity()),
         aggregator_(aggregator),
         calibration_(calibration),
         tracker_(tracker),
-        localization_(localization) {
+        localization_(localization),
+        time_calibration_(time_calibration),
+        recorder_(recorder),
+        publisher_(publisher) {
   }
 
   inline dove_eye::CameraIndex Arity() const {
@@ -81,7 +92,7 @@ class Controller : public QObject {
   }
 
  signals:
-  void FramesetReady(const dove_eye::Frameset);
+  void FramesetReady(const dove_eye::FramesetPtr);
   void PositsetReady(const dove_eye::Positset);
   void LocationReady(const dove_eye::Location);
   void ModeChanged(const Controller::Mode new_mode);
@@ -104,6 +115,7 @@ class Controller : public QObject {
   void Pause();
   void Step();
   void Resume();
+  void Seek(const double timestamp);
 
   void SetMark(const dove_eye::CameraIndex cam, const gui::GuiMark mark);
 
@@ -115,6 +127,15 @@ class Controller : public QObject {
 
   void SetLocalizationActive(const bool value);
 
+  void SetFusedTracking(const bool value);
+
+  void SetTimeCalibrationActive(const bool value);
+
+  void StartRecording(const QString basename, const bool compress);
+  void StopRecording();
+
+  void SetPublishingActive(const bool value);
+
   void SetCalibrationData(const dove_eye::CalibrationData calibration_data);
 
  protected:
@@ -127,6 +148,7 @@ class Controller : public QObject {
   UndistortMode undistort_mode_;
   dove_eye::InnerTracker::Mark::Type tracker_mark_type_;
   bool localization_active_;
+  bool time_calibration_active_;
 
   const dove_eye::CameraIndex arity_;
 
@@ -148,10 +170,14 @@ class Controller : public QObject {
   std::unique_ptr<dove_eye::CameraCalibration> calibration_;
   std::unique_ptr<dove_eye::Tracker> tracker_;
   std::unique_ptr<dove_eye::Localization> localization_;
+  std::unique_ptr<dove_eye::MotionTimeCalibration> time_calibration_;
+  std::unique_ptr<dove_eye::Recorder> recorder_;
+  std::unique_ptr<dove_eye::LocationPublisher> publisher_;
 
   bool FramesetLoop();
 
-  void FramesetLoopTracking(const dove_eye::Positset positset);
+  void FramesetLoopTracking(const dove_eye::Frameset &frameset,
+                            const dove_eye::Positset &positset);
 
   void CalibrationDataToProviders(
       const dove_eye::CalibrationData *calibration_data);
@@ -1,5 +1,7 @@
 #include "frameset_converter.h"
 
+#include <cmath>
+
 #include <QTimerEvent>
 
 #include "dove_eye/logging.h"
@@ -56,11 +58,28 @@ void FramesetConverter::PropagateMark(const dove_eye::CameraIndex cam,
   }
 }
 
-void FramesetConverter::ProcessFrameset(const dove_eye::Frameset &frameset) {
+void FramesetConverter::ProcessFrameset(const dove_eye::FramesetPtr frameset) {
+  assert(frameset);
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    frame_validity_[cam] = frameset->IsValid(cam);
+    if (!frameset->IsValid(cam) || !(*frameset)[cam].data.data) {
+      continue;
+    }
+
+    /*
+     * Update frame size, we do it every frame, however, it's not actually
+     * assumed that frame size would change between frames. Posits and marks
+     * need it even when the frameset isn't displayed.
+     */
+    const auto &data = (*frameset)[cam].data;
+    frame_sizes_[cam].setWidth(data.cols);
+    frame_sizes_[cam].setHeight(data.rows);
+  }
+
   if (allow_drop_) {
     EnqueueFrameset(frameset);
   } else {
-    ProcessFramesetInternal(frameset);
+    ProcessFramesetInternal(*frameset);
   }
 }
 
@@ -77,82 +96,63 @@ void FramesetConverter::timerEvent(QTimerEvent *event) {
     return;
   }
 
-  if (has_frameset_) {
-    ProcessFramesetInternal(frameset_);
-    for (auto &frame : frameset_) {
-      frame.data.release();
-    }
-    has_frameset_ = false;
+  timer_.stop();
+
+  /* Posits wait with their frameset, they're displayed over it */
+  const auto delay = preview_generator_.Delay();
+  if (frameset_ && delay > 0) {
+    timer_.start(std::ceil(1000 * delay), this);
+    return;
+  }
+
+  if (frameset_) {
+    ProcessFramesetInternal(*frameset_);
+    /* Don't hold frame buffers longer than necessary. */
+    frameset_.reset();
   }
 
   if (has_positset_) {
     ProcessPositsetInternal(positset_);
     has_positset_ = false;
   }
-
-  timer_.stop();
 }
 
 void FramesetConverter::ProcessFramesetInternal(
     const dove_eye::Frameset &frameset) {
   ImageList image_list(frameset.Arity());
 
-  for (CameraIndex cam = 0; cam < frameset.Arity(); ++cam) {
-    if (!frameset.IsValid(cam)) {
-      continue;
-    }
-
-    /* Get own copy of frame, we'll modify it. */
-    auto mat = frameset[cam].data.clone();
-    if (!mat.data) {
-      DEBUG("Empty data from cam %i", cam);
-      continue;
-    }
-
-    /*
-     * Update frame size, we do it every frame, however, it's not actually
-     * assumed that frame size would change between frames.
-     */
-    frame_sizes_[cam].setWidth(mat.cols);
-    frame_sizes_[cam].setHeight(mat.rows);
+  preview_generator_.Process(frameset);
 
-    /* Convert image for display. */
+  for (CameraIndex cam = 0; cam < frameset.Arity(); ++cam) {
     if (viewer_sizes_[cam].width() == 0) {
       continue;
     }
 
-    auto new_size = CalculateNewSize(cam, mat.rows, mat.cols);
-    cv::Size cv_new_size(new_size.width(), new_size.height());
-
-    cv::resize(mat, mat, cv_new_size);
-
-    if (mat.channels() == 1) {
-      cv::cvtColor(mat, mat, CV_GRAY2BGR);
-    } else if (mat.channels() == 3) {
-      cv::cvtColor(mat, mat, CV_BGR2RGB);
-    } else {
-      ERROR("Unexpected no. of channels (%i) in cam %i frame.",
-            mat.channels(), cam);
+    /* Invalid frames leave the last preview of the camera */
+    const cv::Mat &preview = preview_generator_.preview(cam);
+    if (!preview.data) {
+      continue;
     }
 
-
     /*
      * Wrap data buffer to QImage object, together with it keep one copy of
      * cv::Mat that will ensure existence of buffer as long as QImage needs it.
+     * Preview is kept by the generator too, hence read-only QImage.
      */
-    image_list[cam] = QImage(mat.data, mat.cols, mat.rows, mat.step,
+    const uchar *data = preview.data;
+    image_list[cam] = QImage(data, preview.cols, preview.rows, preview.step,
                              QImage::Format_RGB888, [](void *mat) {
                                delete static_cast<cv::Mat *>(mat);
-                             }, new cv::Mat(mat));
-    assert(image_list[cam].constBits() == mat.data);
+                             }, new cv::Mat(preview));
+    assert(image_list[cam].constBits() == preview.data);
   }
 
   emit ImagesetReady(image_list);
 }
 
-void FramesetConverter::EnqueueFrameset(const dove_eye::Frameset &frameset) {
+void FramesetConverter::EnqueueFrameset(const dove_eye::FramesetPtr frameset) {
+  /* Replacing the pointer drops pending frameset, nothing is copied. */
   frameset_ = frameset;
-  has_frameset_ = true;
 
   if (!timer_.isActive()) {
     timer_.start(0, this);
@@ -164,7 +164,7 @@ void FramesetConverter::ProcessPositsetInternal(const dove_eye::Positset positse
   ImageList image_list(positset.Arity());
 
   for (CameraIndex cam = 0; cam < positset.Arity(); ++cam) {
-    if (!positset.IsValid(cam) || !frameset_.IsValid(cam)) {
+    if (!positset.IsValid(cam) || !frame_validity_[cam]) {
       continue;
     }
 
@@ -7,7 +7,9 @@
 #include <QVector>
 
 #include "dove_eye/frameset.h"
+#include "dove_eye/parameters.h"
 #include "dove_eye/positset.h"
+#include "dove_eye/preview.h"
 #include "dove_eye/types.h"
 #include "gui/gui_mark.h"
 
@@ -16,7 +18,11 @@
  * \see http://stackoverflow.com/a/21253353/1351874
  *
  * Converts frameset to vector of QImage. If a frame is not valid,
- * default empty QImage instance is returned.
+ * last preview of the camera is returned (default empty QImage when none).
+ *
+ * Framesets arriving faster than PREVIEW_RATE are dropped, the latest one is
+ * deferred until its preview is due (so that the last delivered frameset is
+ * always displayed).
  */
 
 class FramesetConverter : public QObject {
@@ -25,10 +31,12 @@ class FramesetConverter : public QObject {
  public:
   typedef QVector<QImage> ImageList;
 
-  explicit FramesetConverter(const dove_eye::CameraIndex arity)
+  FramesetConverter(const dove_eye::Parameters &parameters,
+                    const dove_eye::CameraIndex arity)
       : QObject(),
-        has_frameset_(false),
-        frameset_(arity),
+        arity_(arity),
+        preview_generator_(parameters, arity),
+        frame_validity_(arity),
         has_positset_(false),
         positset_(arity),
         frame_sizes_(arity),
@@ -36,7 +44,15 @@ class FramesetConverter : public QObject {
   }
 
   inline dove_eye::CameraIndex Arity() const {
-    return frameset_.Arity();
+    return arity_;
+  }
+
+  /** Whether framesets may be dropped (and deferred) to keep PREVIEW_RATE
+   *
+   * When not allowed, every frameset is converted on arrival.
+   */
+  inline void allow_drop(const bool value) {
+    allow_drop_ = value;
   }
 
   void SetFrameSize(const dove_eye::CameraIndex cam, const QSize size);
@@ -52,7 +68,7 @@ class FramesetConverter : public QObject {
                    const gui::GuiMark mark);
 
  public slots:
-  void ProcessFrameset(const dove_eye::Frameset &frameset);
+  void ProcessFrameset(const dove_eye::FramesetPtr frameset);
   void ProcessPositset(const dove_eye::Positset positset);
 
  protected:
@@ -61,8 +77,14 @@ class FramesetConverter : public QObject {
  private:
   QBasicTimer timer_;
 
-  bool has_frameset_;
-  dove_eye::Frameset frameset_;
+  const dove_eye::CameraIndex arity_;
+
+  dove_eye::PreviewGenerator preview_generator_;
+
+  /** Pending frameset, released once converted */
+  dove_eye::FramesetPtr frameset_;
+  /** Validity of frames in the last received frameset */
+  QVector<bool> frame_validity_;
 
   bool has_positset_;
   dove_eye::Positset positset_;
@@ -76,7 +98,7 @@ class FramesetConverter : public QObject {
                          size_t frame_rows, size_t frame_cols);
 
   void ProcessFramesetInternal(const dove_eye::Frameset &frameset);
-  void EnqueueFrameset(const dove_eye::Frameset &frameset);
+  void EnqueueFrameset(const dove_eye::FramesetPtr frameset);
 
   void ProcessPositsetInternal(const dove_eye::Positset positset);
   void EnqueuePositset(const dove_eye::Positset positset);
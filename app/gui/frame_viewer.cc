@@ -39,7 +39,9 @@ void FrameViewer::SetConverter(FramesetConverter *converter,
 
 void FrameViewer::paintEvent(QPaintEvent *event) {
   QPainter painter(this);
-  painter.drawImage(0, 0, image_);
+  /* Fit preview into viewer, cf. FramesetConverter::CalculateNewSize() */
+  QSize target_size = image_.size().scaled(size(), Qt::KeepAspectRatio);
+  painter.drawImage(QRect(QPoint(0, 0), target_size), image_);
   undrawn_image_ = false;
 
   if (has_posit_) {
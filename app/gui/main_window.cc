@@ -20,6 +20,7 @@ using dove_eye::Parameters;
 using gui::FramesetViewer;
 using widgets::CalibrationStatus;
 using widgets::ControllerStatus;
+using widgets::MetricsStatus;
 using widgets::PlaybackControl;
 using widgets::SceneViewer;
 
@@ -66,6 +67,7 @@ MainWindow::~MainWindow() {
 void MainWindow::SetupPipeline() {
   ui_->viewer->SetArity(application_->Arity());
   calibration_status_->SetArity(application_->Arity());
+  metrics_status_->SetArity(application_->Arity());
 
   if (application_->Arity() == 0) {
     SetCalibration(false);
@@ -113,6 +115,27 @@ void MainWindow::SetupPipeline() {
           application_->controller(), &Controller::SetLocalizationActive);
   connect(this, &MainWindow::SetUndistortMode,
           application_->controller(), &Controller::SetUndistortMode);
+  connect(this, &MainWindow::SetTimeCalibrationActive,
+          application_->controller(), &Controller::SetTimeCalibrationActive);
+  connect(this, &MainWindow::StartRecording,
+          application_->controller(), &Controller::StartRecording);
+  connect(this, &MainWindow::StopRecording,
+          application_->controller(), &Controller::StopRecording);
+  connect(this, &MainWindow::SetPublishingActive,
+          application_->controller(), &Controller::SetPublishingActive);
+  connect(this, &MainWindow::SetFusedTracking,
+          application_->controller(), &Controller::SetFusedTracking);
+
+  /* New controller doesn't record */
+  ui_->action_recording_start->setVisible(true);
+  ui_->action_recording_stop->setVisible(false);
+
+  /* New controller starts without time calibration */
+  ui_->action_calibrate_time->setChecked(false);
+
+  /* Keep publishing and tracking mode across controllers */
+  LocalizationPublish();
+  LocalizationFused();
 
   /* Controller -> PlaybackControl */
   connect(application_->controller(), &Controller::Started,
@@ -131,6 +154,8 @@ void MainWindow::SetupPipeline() {
           application_->controller(), &Controller::Resume);
   connect(ui_->playback_control, &PlaybackControl::Stepped,
           application_->controller(), &Controller::Step);
+  connect(ui_->playback_control, &PlaybackControl::Sought,
+          application_->controller(), &Controller::Seek);
 
 }
 
@@ -169,6 +194,10 @@ void MainWindow::CalibrationSave() {
       ->SaveToFile(filename, application_->calibration_data());
 }
 
+void MainWindow::CalibrateTime() {
+  emit SetTimeCalibrationActive(ui_->action_calibrate_time->isChecked());
+}
+
 void MainWindow::LocalizationStart() {
   emit SetLocalizationActive(true);
   ui_->action_localization_start->setVisible(false);
@@ -181,6 +210,14 @@ void MainWindow::LocalizationStop() {
   ui_->action_localization_stop->setVisible(false);
 }
 
+void MainWindow::LocalizationPublish() {
+  emit SetPublishingActive(ui_->action_localization_publish->isChecked());
+}
+
+void MainWindow::LocalizationFused() {
+  emit SetFusedTracking(ui_->action_localization_fused->isChecked());
+}
+
 void MainWindow::LocalizationSave() {
     auto filename = QFileDialog::getSaveFileName(this, tr("Save localization data"), "",
                                                  tr("XML files (*.xml)"));
@@ -218,6 +255,28 @@ void MainWindow::OpenVideoFiles() {
   open_videos_dialog_->show();
 }
 
+void MainWindow::RecordingStart() {
+  auto filename = QFileDialog::getSaveFileName(this, tr("Record to"), "",
+                                               tr("Recordings (*.dvr)"));
+  if (filename.isNull()) {
+    return;
+  }
+  /* Stream files are suffixed by camera number */
+  if (filename.endsWith(".dvr")) {
+    filename.chop(4);
+  }
+
+  emit StartRecording(filename, ui_->action_recording_compress->isChecked());
+  ui_->action_recording_start->setVisible(false);
+  ui_->action_recording_stop->setVisible(true);
+}
+
+void MainWindow::RecordingStop() {
+  emit StopRecording();
+  ui_->action_recording_start->setVisible(true);
+  ui_->action_recording_stop->setVisible(false);
+}
+
 void MainWindow::ParametersModify() {
   parameters_dialog_->LoadValues();
   parameters_dialog_->show();
@@ -252,7 +311,12 @@ void MainWindow::ControllerModeChanged(const Controller::Mode mode) {
   ui_->action_calibrate->setVisible(mode != Controller::kCalibration);
   ui_->action_calibrate->setEnabled(mode != Controller::kNonexistent);
   ui_->action_calibration_load->setEnabled(mode != Controller::kNonexistent);
+  ui_->action_calibrate_time->setEnabled(mode != Controller::kNonexistent &&
+                                         application_->Arity() > 1);
   action_group_distortion_->setEnabled(mode != Controller::kNonexistent);
+  ui_->action_recording_start->setEnabled(mode != Controller::kNonexistent);
+  ui_->action_localization_publish->setEnabled(
+      mode != Controller::kNonexistent);
 
   /* Update status bar */
   bool show_calibration = (mode == Controller::kCalibration);
@@ -278,6 +342,7 @@ void MainWindow::SetCalibration(const bool value) {
   ui_->action_distortion_video->setEnabled(value);
 
   ui_->action_localization_start->setEnabled(value);
+  ui_->action_localization_fused->setEnabled(value);
 }
 
 void MainWindow::SetupStatusBar() {
@@ -286,6 +351,9 @@ void MainWindow::SetupStatusBar() {
 
   calibration_status_ = new CalibrationStatus();
   statusBar()->addWidget(calibration_status_);
+
+  metrics_status_ = new MetricsStatus();
+  statusBar()->addPermanentWidget(metrics_status_);
 }
 
 void MainWindow::SetupMenu() {
@@ -304,14 +372,24 @@ void MainWindow::SetupMenu() {
           this, &MainWindow::CalibrationLoad);
   connect(ui_->action_calibration_save, &QAction::triggered,
           this, &MainWindow::CalibrationSave);
+  connect(ui_->action_calibrate_time, &QAction::triggered,
+          this, &MainWindow::CalibrateTime);
   connect(ui_->action_localization_start, &QAction::triggered,
           this, &MainWindow::LocalizationStart);
   connect(ui_->action_localization_stop, &QAction::triggered,
           this, &MainWindow::LocalizationStop);
   connect(ui_->action_localization_save, &QAction::triggered,
           this, &MainWindow::LocalizationSave);
+  connect(ui_->action_localization_publish, &QAction::triggered,
+          this, &MainWindow::LocalizationPublish);
+  connect(ui_->action_localization_fused, &QAction::triggered,
+          this, &MainWindow::LocalizationFused);
   connect(ui_->action_open_video_files, &QAction::triggered,
           this, &MainWindow::OpenVideoFiles);
+  connect(ui_->action_recording_start, &QAction::triggered,
+          this, &MainWindow::RecordingStart);
+  connect(ui_->action_recording_stop, &QAction::triggered,
+          this, &MainWindow::RecordingStop);
   connect(ui_->action_parameters_modify, &QAction::triggered,
           this, &MainWindow::ParametersModify);
   connect(ui_->action_parameters_load, &QAction::triggered,
@@ -330,6 +408,7 @@ void MainWindow::SetupMenu() {
   /* Synchronize stateful menus */
   SceneShowCameras();
   LocalizationStop();
+  ui_->action_recording_stop->setVisible(false);
 }
 
 } // end namespace gui
@@ -15,6 +15,7 @@
 #include "parameters_dialog.h"
 #include "widgets/calibration_status.h"
 #include "widgets/controller_status.h"
+#include "widgets/metrics_status.h"
 #include "widgets/playback_control.h"
 
 namespace Ui {
@@ -33,6 +34,11 @@ class MainWindow : public QMainWindow {
  signals:
   void SetControllerMode(const Controller::Mode mode);
   void SetLocalizationActive(const bool value);
+  void SetTimeCalibrationActive(const bool value);
+  void SetPublishingActive(const bool value);
+  void SetFusedTracking(const bool value);
+  void StartRecording(const QString basename, const bool compress);
+  void StopRecording();
   void SetUndistortMode(const Controller::UndistortMode undistort_mode);
 
  public slots:
@@ -44,13 +50,18 @@ class MainWindow : public QMainWindow {
   void Calibrate();
   void CalibrationLoad();
   void CalibrationSave();
+  void CalibrateTime();
   void LocalizationStart();
   void LocalizationStop();
   void LocalizationSave();
+  void LocalizationPublish();
+  void LocalizationFused();
   void GroupDistortion(QAction *action);
   void SceneShowCameras();
   void SceneClearTrajectory();
   void OpenVideoFiles();
+  void RecordingStart();
+  void RecordingStop();
   void ParametersModify();
   void ParametersLoad();
   void ParametersSave();
@@ -70,6 +81,7 @@ class MainWindow : public QMainWindow {
 
   widgets::ControllerStatus *controller_status_;
   widgets::CalibrationStatus *calibration_status_;
+  widgets::MetricsStatus *metrics_status_;
 
   void SetupStatusBar();
   void SetupMenu();
@@ -2,12 +2,16 @@
 
 #include <QMessageBox>
 
-#include "dove_eye/camera_video_provider.h"
+#include "config.h"
+#include "dove_eye/ffmpeg_video_provider.h"
+#include "dove_eye/file_video_provider.h"
+#include "dove_eye/recording_video_provider.h"
 #include "ui_open_videos_dialog.h"
 #include "widgets/file_selector.h"
 
 using dove_eye::CameraIndex;
 using dove_eye::FileVideoProvider;
+using dove_eye::VideoProvider;
 
 namespace gui {
 
@@ -99,10 +103,20 @@ void OpenVideosDialog::OnAccepted() const {
   providers_ptr_->clear();
 }
 
-FileVideoProvider *OpenVideosDialog::CreateVideoProvider(const QString &filename)
+VideoProvider *OpenVideosDialog::CreateVideoProvider(const QString &filename)
     const {
-  // TODO
-  auto provider = new FileVideoProvider(filename.toStdString());
+  if (dove_eye::RecordingVideoProvider::IsRecording(filename.toStdString())) {
+    VideoProvider *provider =
+        new dove_eye::RecordingVideoProvider(filename.toStdString());
+    return provider;
+  }
+
+#ifdef CONFIG_HAVE_FFMPEG
+  VideoProvider *provider =
+      new dove_eye::FfmpegVideoProvider(filename.toStdString());
+#else
+  VideoProvider *provider = new FileVideoProvider(filename.toStdString());
+#endif
   if (provider->begin() == provider->end()) {
     delete provider;
     provider = nullptr;
@@ -7,8 +7,8 @@
 #include <QString>
 
 #include "application.h"
-#include "dove_eye/file_video_provider.h"
 #include "dove_eye/types.h"
+#include "dove_eye/video_provider.h"
 
 namespace Ui {
 class OpenVideosDialog;
@@ -37,7 +37,7 @@ class OpenVideosDialog : public QDialog {
  private:
   std::unique_ptr<Ui::OpenVideosDialog> ui_;
 
-  dove_eye::FileVideoProvider *CreateVideoProvider(const QString &filename) const;
+  dove_eye::VideoProvider *CreateVideoProvider(const QString &filename) const;
 
   Application::VideoProvidersVectorOwning *providers_ptr_;
 };
@@ -25,6 +25,7 @@ void RegisterMetaTypes() {
   qRegisterMetaType<FramesetConverter::ImageList>("ImageList");
 
   qRegisterMetaType<dove_eye::Frameset>();
+  qRegisterMetaType<dove_eye::FramesetPtr>();
   qRegisterMetaType<dove_eye::Positset>();
 
   qRegisterMetaType<gui::GuiMark>();
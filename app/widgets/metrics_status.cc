@@ -0,0 +1,90 @@
+#include "widgets/metrics_status.h"
+
+#include <QHBoxLayout>
+#include <QTimerEvent>
+
+#include "dove_eye/metrics.h"
+
+using dove_eye::CameraIndex;
+using dove_eye::Metrics;
+
+namespace {
+
+QString Key(const std::string &name, const std::string &labels) {
+  return QString::fromStdString(name + "{" + labels + "}");
+}
+
+} // anonymous namespace
+
+namespace widgets {
+
+MetricsStatus::MetricsStatus(QWidget *parent)
+    : QWidget(parent),
+      arity_(0) {
+  auto new_layout = new QHBoxLayout();
+  label_ = new QLabel();
+  new_layout->addWidget(label_);
+  delete layout();
+  setLayout(new_layout);
+
+  elapsed_.start();
+  timer_.start(kRefreshInterval, this);
+}
+
+void MetricsStatus::SetArity(const CameraIndex arity) {
+  arity_ = arity;
+  RefreshStatus();
+}
+
+void MetricsStatus::timerEvent(QTimerEvent *event) {
+  if (event->timerId() != timer_.timerId()) {
+    return;
+  }
+
+  RefreshStatus();
+}
+
+void MetricsStatus::RefreshStatus() {
+  ValueMap values;
+  for (auto &sample : Metrics::Instance().Samples()) {
+    values[Key(sample.name, sample.labels)] = sample.value;
+  }
+
+  const double seconds = elapsed_.restart() / 1000.0;
+  auto rate = [&](const QString &key) {
+    const double difference = values.value(key) - last_values_.value(key);
+    return (seconds > 0) ? difference / seconds : 0;
+  };
+
+  QString status;
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    const auto label = Metrics::CamLabel(cam);
+    const auto frames = Key("dove_eye_frames_captured_total", label);
+    const auto dropped = Key("dove_eye_frames_dropped_total", label);
+    const auto state = Key("dove_eye_tracker_state", label);
+
+    QString state_name;
+    switch (static_cast<int>(values.value(state))) {
+      case 1:
+        state_name = ", tracking";
+        break;
+      case 2:
+        state_name = ", lost";
+        break;
+    }
+
+    status += QString("Cam %0: %1 fps, %2 dropped%3; ")
+        .arg(cam)
+        .arg(rate(frames), 0, 'f', 1)
+        .arg(values.value(dropped))
+        .arg(state_name);
+  }
+
+  const auto skew = values.value(Key("dove_eye_aggregator_skew_seconds", ""));
+  status += QString("skew %0 ms").arg(skew * 1000, 0, 'f', 1);
+
+  label_->setText(status);
+  last_values_ = values;
+}
+
+} // end namespace widgets
@@ -0,0 +1,50 @@
+#ifndef WIDGETS_METRICS_STATUS_H_
+#define WIDGETS_METRICS_STATUS_H_
+
+
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QMap>
+#include <QString>
+#include <QWidget>
+
+#include "dove_eye/types.h"
+
+
+namespace widgets {
+
+/** Summary of runtime metrics (capture rates, drops, tracker states)
+ *
+ * Metrics are polled from the registry once a second, rates are computed
+ * from counter differences.
+ */
+class MetricsStatus : public QWidget {
+  Q_OBJECT
+ public:
+  explicit MetricsStatus(QWidget *parent = nullptr);
+
+  void SetArity(const dove_eye::CameraIndex arity);
+
+ protected:
+  void timerEvent(QTimerEvent *event) override;
+
+ private:
+  typedef QMap<QString, double> ValueMap;
+
+  static const int kRefreshInterval = 1000;
+
+  dove_eye::CameraIndex arity_;
+
+  QBasicTimer timer_;
+  QElapsedTimer elapsed_;
+  ValueMap last_values_;
+
+  QLabel *label_;
+
+  void RefreshStatus();
+};
+
+} // end namespace widgets
+
+#endif // WIDGETS_METRICS_STATUS_H_
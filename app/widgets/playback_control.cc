@@ -16,6 +16,8 @@ PlaybackControl::PlaybackControl(QWidget *parent)
           this, &PlaybackControl::PauseClicked);
   connect(ui_->btn_step, &QPushButton::clicked,
           this, &PlaybackControl::StepClicked);
+  connect(ui_->btn_seek, &QPushButton::clicked,
+          this, &PlaybackControl::SeekClicked);
 
   SetState(kStopped);
 }
@@ -59,6 +61,10 @@ void PlaybackControl::StepClicked() {
   emit Stepped();
 }
 
+void PlaybackControl::SeekClicked() {
+  emit Sought(ui_->spin_seek->value());
+}
+
 void PlaybackControl::SetState(State state) {
   state_ = state;
 
@@ -35,6 +35,8 @@ class PlaybackControl : public QWidget {
 
   void Stepped();
 
+  void Sought(double timestamp);
+
  public slots:
   void Start();
   void Pause();
@@ -44,6 +46,7 @@ class PlaybackControl : public QWidget {
   void PlayClicked();
   void PauseClicked();
   void StepClicked();
+  void SeekClicked();
   void SetState(State state);
 
  private:
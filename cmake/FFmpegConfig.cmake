@@ -0,0 +1,22 @@
+cmake_minimum_required(VERSION 2.8.11)
+
+# Direct decoding backend (optional), requires FFmpeg 4.0 or newer.
+
+set(CMAKE_LIBRARY_PATH ${FFmpeg_ROOT}/lib;${CMAKE_LIBRARY_PATH})
+
+find_path(FFmpeg_INCLUDE_DIR
+	NAMES libavformat/avformat.h
+	PATHS ${FFmpeg_ROOT}/include
+	PATH_SUFFIXES ffmpeg)
+
+find_library(avformat_LIB NAMES avformat)
+find_library(avcodec_LIB NAMES avcodec)
+find_library(avutil_LIB NAMES avutil)
+find_library(swscale_LIB NAMES swscale)
+
+if(FFmpeg_INCLUDE_DIR AND avformat_LIB AND avcodec_LIB AND avutil_LIB AND swscale_LIB)
+	set(FFmpeg_INCLUDE_DIRS ${FFmpeg_INCLUDE_DIR})
+	set(FFmpeg_LIBS ${avformat_LIB};${avcodec_LIB};${swscale_LIB};${avutil_LIB})
+else()
+	set(FFmpeg_FOUND FALSE)
+endif()
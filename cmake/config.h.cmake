@@ -7,4 +7,6 @@
 
 #cmakedefine CONFIG_SINGLE_THREADED
 
+#cmakedefine CONFIG_HAVE_FFMPEG
+
 #endif // CONFIG_H_
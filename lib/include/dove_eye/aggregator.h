@@ -10,6 +10,7 @@
 #include "dove_eye/frameset.h"
 #include "dove_eye/frame_iterator.h"
 #include "dove_eye/logging.h"
+#include "dove_eye/metrics.h"
 #include "dove_eye/parameters.h"
 #include "dove_eye/video_provider.h"
 
@@ -21,6 +22,7 @@ class Aggregator {
  public:
   friend class AggregatorIterator;
   typedef std::vector<VideoProvider *> ProvidersContainer;
+  typedef std::vector<Frame::Timestamp> TimestampsContainer;
   typedef AggregatorIterator Iterator;
 
   /**
@@ -30,7 +32,15 @@ class Aggregator {
              const dove_eye::Parameters &parameters)
       : arity_(providers.size()),
         parameters_(parameters),
-        providers_(providers) {
+        providers_(providers),
+        skew_metric_(Metrics::Instance().GetGauge(
+                "dove_eye_aggregator_skew_seconds", "",
+                "Timestamp spread of frames in the last frameset")) {
+    for (CameraIndex cam = 0; cam < arity_; ++cam) {
+      frames_metrics_.push_back(&Metrics::Instance().GetCounter(
+              "dove_eye_frames_captured_total", Metrics::CamLabel(cam),
+              "Frames received from capture"));
+    }
   }
 
   virtual ~Aggregator() {
@@ -59,14 +69,26 @@ class Aggregator {
     return parameters_;
   }
 
+  /** Number of frames of the camera dropped (by capture) since start */
+  virtual size_t Dropped(const CameraIndex cam) const = 0;
+
  private:
   CameraIndex arity_;
   const Parameters &parameters_;
   ProvidersContainer providers_;
 
+  std::vector<Counter *> frames_metrics_;
+  Gauge &skew_metric_;
+
   virtual void Start() = 0;
 
   virtual bool GetFrame(Frame *frame, CameraIndex *cam) = 0;
+
+  /** Move each provider to its timestamp
+   *
+   * @return False when any provider is not seekable.
+   */
+  virtual bool Seek(const TimestampsContainer &timestamps) = 0;
 };
 
 } // namespace dove_eye
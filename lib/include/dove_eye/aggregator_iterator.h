@@ -26,10 +26,24 @@ class AggregatorIterator {
 
   AggregatorIterator &operator++();
 
-  inline Frameset operator*() const {
+  /** Re-synchronize all providers to the timestamp
+   *
+   * On success iterator points to the first frameset after the timestamp
+   * (it may be end iterator when providers are exhausted).
+   *
+   * @return False when providers cannot seek, iterator is unchanged then.
+   */
+  bool Seek(const Frame::Timestamp timestamp);
+
+  /** Reference is valid until the iterator is incremented */
+  inline const Frameset &operator*() const {
     return frameset_;
   }
 
+  inline const Frameset *operator->() const {
+    return &frameset_;
+  }
+
   inline bool operator==(const AggregatorIterator &rhs) const {
     return !valid_ && !rhs.valid_;
   }
@@ -15,6 +15,7 @@
 #include "dove_eye/frameset_aggregator.h"
 #include "dove_eye/types.h"
 #include "dove_eye/logging.h"
+#include "dove_eye/metrics.h"
 #include "dove_eye/video_provider.h"
 
 
@@ -28,7 +29,16 @@ class AsyncPolicy {
   explicit AsyncPolicy(const ProvidersContainer &providers)
       : providers_(providers),
         threads_(providers_.size()),
-        max_queue_size_(providers_.size() * kQueueSizeFactor_) {
+        max_queue_size_(providers_.size() * kQueueSizeFactor_),
+        dropped_(providers_.size(), 0),
+        queue_metric_(Metrics::Instance().GetGauge(
+                "dove_eye_capture_queue_depth", "",
+                "Frames waiting for the aggregator")) {
+    for (CameraIndex cam = 0; cam < providers_.size(); ++cam) {
+      dropped_metrics_.push_back(&Metrics::Instance().GetCounter(
+              "dove_eye_frames_dropped_total", Metrics::CamLabel(cam),
+              "Frames dropped by capture because of full queue"));
+    }
   }
 
   ~AsyncPolicy() {
@@ -65,6 +75,7 @@ class AsyncPolicy {
 
     auto cam_frame = queue_.front();
     queue_.pop();
+    queue_metric_.Set(queue_.size());
     queue_cv_.notify_all();
     lock.unlock();
 
@@ -73,6 +84,17 @@ class AsyncPolicy {
     return true;
   }
 
+  /** Number of frames of the camera dropped since start */
+  size_t Dropped(const CameraIndex cam) const {
+    Lock lock(queue_mtx_);
+    return dropped_[cam];
+  }
+
+  /** Live streams cannot be seeked */
+  bool Seek(const std::vector<Frame::Timestamp> &timestamps) {
+    return false;
+  }
+
  private:
   typedef std::vector<std::thread> ThreadContainer;
   typedef std::unique_lock<std::mutex> Lock;
@@ -90,9 +112,13 @@ class AsyncPolicy {
   std::atomic<bool> stop_requested_;
 
   std::queue<CamFrame> queue_;
-  std::mutex queue_mtx_;
+  std::vector<size_t> dropped_;
+  mutable std::mutex queue_mtx_;
   std::condition_variable queue_cv_;
 
+  std::vector<Counter *> dropped_metrics_;
+  Gauge &queue_metric_;
+
 
   void ReadProvider(const CameraIndex cam) {
     for (auto frame : *providers_[cam]) {
@@ -101,6 +127,8 @@ class AsyncPolicy {
 
       if (queue_.size() == max_queue_size_) {
         if (allow_drop) {
+          dropped_[cam] += 1;
+          dropped_metrics_[cam]->Add();
           continue;
         } else {
           queue_cv_.wait(lock, [&] {
@@ -115,6 +143,7 @@ class AsyncPolicy {
       }
 
       queue_.push(CamFrame(frame, cam));
+      queue_metric_.Set(queue_.size());
       queue_cv_.notify_all();
     }
 
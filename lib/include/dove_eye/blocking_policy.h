@@ -64,6 +64,29 @@ class BlockingPolicy {
     return true;
   }
 
+  /** Frames are never dropped */
+  inline size_t Dropped(const CameraIndex cam) const {
+    return 0;
+  }
+
+  bool Seek(const std::vector<Frame::Timestamp> &timestamps) {
+    assert(initialized_);
+    assert(timestamps.size() == providers_.size());
+
+    for (auto provider : providers_) {
+      if (!provider->Seekable()) {
+        return false;
+      }
+    }
+
+    for (int i = 0; i < providers_.size(); ++i) {
+      iterators_[i] = providers_[i]->Seek(timestamps[i]);
+    }
+    current_cam_ = 0;
+
+    return true;
+  }
+
  private:
   typedef std::vector<FrameIterator> Iterators;
 
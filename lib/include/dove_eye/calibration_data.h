@@ -34,6 +34,7 @@ struct PairParameters {
  */
 class CalibrationData {
   friend class CameraCalibration;
+  friend class SyntheticScene;
 #ifdef HAVE_GUI
   friend CalibrationData io::CalibrationDataStorage::LoadFromFile(const QString &);
 #endif
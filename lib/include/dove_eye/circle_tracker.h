@@ -88,6 +88,11 @@ class CircleTracker : public SearchingTracker {
                           const CircleData &circle_data,
                           const double threshold) const;
 
+  bool FitCircle(const cv::Mat &data_proc,
+                 const double min_radius,
+                 const double max_radius,
+                 Circle *result) const;
+
   double CirclesToMark(const cv::Mat& data,
                      const CircleVector &circles,
                      Mark *mark) const;
@@ -0,0 +1,178 @@
+#ifndef DOVE_EYE_CONSTANT_VELOCITY_KALMAN_H_
+#define DOVE_EYE_CONSTANT_VELOCITY_KALMAN_H_
+
+#include <array>
+#include <cmath>
+
+namespace dove_eye {
+
+/** Constant velocity Kalman filter of D-dimensional position, fixed size
+ *
+ * Equivalent of cv::KalmanFilter(2 * D, D, 0) with state (position,
+ * velocity), unit time step, identity measurement matrix and isotropic
+ * process/observation noise, as set up by CvKalmanFilter. All storage is
+ * inline, no operation allocates.
+ *
+ * With such matrices (and initial covariance being identity) axes never
+ * become correlated, thus the filter is kept as D independent 2x2 problems
+ * and matrix products are written out. Intermediate results are rounded to
+ * float at the same points as cv::KalmanFilter does (its gemm accumulates in
+ * double), the only difference is 1x1 solve instead of SVD.
+ *
+ * Like cv::KalmanFilter it keeps both a priori (pre) and a posteriori (post)
+ * estimates, Predict() copies pre to post and Correct() uses pre.
+ */
+template<int D>
+class ConstantVelocityKalman {
+ public:
+  typedef float Scalar;
+  typedef std::array<Scalar, D> Vector;
+
+  ConstantVelocityKalman()
+      : process_var_(1),
+        observation_var_(1) {
+    for (auto &axis : axes_) {
+      axis = Axis();
+    }
+  }
+
+  inline void Init(const double process_var, const double observation_var) {
+    process_var_ = process_var;
+    observation_var_ = observation_var;
+  }
+
+  /** Set a posteriori state to still object with unit covariance */
+  inline void Reset(const Vector &position) {
+    for (int d = 0; d < D; ++d) {
+      auto &axis = axes_[d];
+      axis.post = State(position[d], 0);
+      axis.cov_post = Covariance(1, 0, 0, 1);
+    }
+  }
+
+  inline void Predict() {
+    const Scalar q = process_var_;
+    for (auto &axis : axes_) {
+      const auto &s = axis.post;
+      const auto &p = axis.cov_post;
+
+      /* x' = A x */
+      axis.pre = State(Round(Wide(s.x) + s.v), s.v);
+
+      /* P' = (A P) A^T + Q */
+      const Covariance ap(Round(Wide(p.pp) + p.vp), Round(Wide(p.pv) + p.vv),
+                          p.vp, p.vv);
+      axis.cov_pre = Covariance(Round(Wide(ap.pp) + ap.pv + q), ap.pv,
+                                Round(Wide(ap.vp) + ap.vv),
+                                Round(Wide(ap.vv) + q));
+
+      axis.post = axis.pre;
+      axis.cov_post = axis.cov_pre;
+    }
+  }
+
+  inline void Correct(const Vector &observation) {
+    const Scalar r = observation_var_;
+    for (int d = 0; d < D; ++d) {
+      auto &axis = axes_[d];
+      const auto &s = axis.pre;
+      const auto &p = axis.cov_pre;
+
+      /* K = P H^T (H P H^T + R)^-1 */
+      const Scalar innovation_var = Round(Wide(p.pp) + r);
+      const Scalar k_x = p.pp / innovation_var;
+      const Scalar k_v = p.pv / innovation_var;
+
+      /* x = x' + K (z - H x') */
+      const Scalar residual = Round(Wide(observation[d]) - s.x);
+      axis.post = State(Round(s.x + Wide(k_x) * residual),
+                        Round(s.v + Wide(k_v) * residual));
+
+      /* P = P' - K H P' */
+      axis.cov_post = Covariance(Round(p.pp - Wide(k_x) * p.pp),
+                                 Round(p.pv - Wide(k_x) * p.pv),
+                                 Round(p.vp - Wide(k_v) * p.pp),
+                                 Round(p.vv - Wide(k_v) * p.pv));
+    }
+  }
+
+  inline Vector position_pre() const {
+    Vector result;
+    for (int d = 0; d < D; ++d) {
+      result[d] = axes_[d].pre.x;
+    }
+    return result;
+  }
+
+  inline Vector velocity_pre() const {
+    Vector result;
+    for (int d = 0; d < D; ++d) {
+      result[d] = axes_[d].pre.v;
+    }
+    return result;
+  }
+
+  inline Vector position_post() const {
+    Vector result;
+    for (int d = 0; d < D; ++d) {
+      result[d] = axes_[d].post.x;
+    }
+    return result;
+  }
+
+  /** Square root of diagonal of H P' H^T + R */
+  inline Vector ObservationDeviation() const {
+    Vector result;
+    for (int d = 0; d < D; ++d) {
+      result[d] = std::sqrt(axes_[d].cov_pre.pp + observation_var_);
+    }
+    return result;
+  }
+
+ private:
+  struct State {
+    Scalar x;
+    Scalar v;
+
+    State(const Scalar x = 0, const Scalar v = 0)
+        : x(x), v(v) {
+    }
+  };
+
+  struct Covariance {
+    Scalar pp;
+    Scalar pv;
+    Scalar vp;
+    Scalar vv;
+
+    Covariance(const Scalar pp = 0, const Scalar pv = 0,
+               const Scalar vp = 0, const Scalar vv = 0)
+        : pp(pp), pv(pv), vp(vp), vv(vv) {
+    }
+  };
+
+  struct Axis {
+    State pre;
+    State post;
+    Covariance cov_pre;
+    Covariance cov_post;
+  };
+
+  /* Noise matrices are float in cv::KalmanFilter too */
+  Scalar process_var_;
+  Scalar observation_var_;
+  std::array<Axis, D> axes_;
+
+  /* cv::gemm on float matrices accumulates in double */
+  static inline double Wide(const Scalar value) {
+    return value;
+  }
+
+  static inline Scalar Round(const double value) {
+    return static_cast<Scalar>(value);
+  }
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_CONSTANT_VELOCITY_KALMAN_H_
@@ -14,6 +14,10 @@ namespace dove_eye {
 /**
  * CvFrameIterator uses global mutex dove_eye::cv_capture_mtx to serialize
  * access to OpenCV capture creation/disposal.
+ *
+ * Constructor only opens the capture so that it can be configured, the first
+ * frame is read with MoveNext() (or Reposition() after seeking) before the
+ * iterator is handed over to FrameIterator.
  */
 template<typename TimestampPolicy, typename BlockingPolicy>
 class CvFrameIterator : public FrameIteratorImpl {
@@ -54,6 +58,15 @@ class CvFrameIterator : public FrameIteratorImpl {
     return *video_capture_;
   }
 
+  /** Read frame at the current position of seeked capture
+   *
+   * \param frame_no  number of the frame capture was positioned to
+   */
+  inline void Reposition(const size_t frame_no) {
+    timestamp_policy_.Seek(frame_no);
+    MoveNext();
+  }
+
  private:
   struct CaptureDeleter {
     void operator()(cv::VideoCapture *to_delete) const {
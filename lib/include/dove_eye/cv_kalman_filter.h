@@ -1,45 +1,54 @@
 #ifndef DOVE_EYE_CV_KALMAN_FILTER_H_
 #define DOVE_EYE_CV_KALMAN_FILTER_H_
 
-#include <opencv2/opencv.hpp>
-
+#include "dove_eye/constant_velocity_kalman.h"
 #include "dove_eye/types.h"
 
 namespace dove_eye {
 
-
+/** Kalman filter of 2D position with constant velocity model
+ *
+ * Originally a wrapper of cv::KalmanFilter, now backed by fixed-size
+ * ConstantVelocityKalman with the same semantics (and no allocations).
+ */
 class CvKalmanFilter {
  public:
   CvKalmanFilter()
-      : kalman_filter_(4, 2, 0),
-        prediction_valid_(false) {
+      : prediction_valid_(false) {
   }
 
-  CvKalmanFilter(const CvKalmanFilter &other);
-
   void Init(const double process_var, const double observation_var);
 
   Point2 Predict(const double time);
 
   Point2 PredictChange(const double time);
 
+  /** Standard deviation of the next observation (x, y)
+   *
+   * Square root of diagonal of innovation covariance, i.e. predicted error
+   * covariance of position plus observation noise.
+   */
+  Point2 PredictDeviation(const double time);
+
   Point2 Update(const double time, const Point2 observation);
 
+  /** Accept prediction as the estimate (no observation available)
+   *
+   * Next prediction is made from this one and uncertainty keeps growing.
+   */
+  Point2 Coast(const double time);
+
   Point2 Reset(const double time = 0, const Point2 observation = Point2());
 
  private:
-  typedef float MatType;
+  typedef ConstantVelocityKalman<2> FilterT;
 
-  cv::KalmanFilter kalman_filter_;
-  cv::Mat prediction_;
+  FilterT kalman_filter_;
   bool prediction_valid_;
 
-  cv::Mat CreateTransition(const double delta) const;
-
   void RefreshPrediction();
 };
 
 } // namespace dove_eye
 
 #endif // DOVE_EYE_CV_KALMAN_FILTER_H_
-
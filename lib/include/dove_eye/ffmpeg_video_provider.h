@@ -0,0 +1,49 @@
+#ifndef DOVE_EYE_FFMPEG_VIDEO_PROVIDER_H_
+#define DOVE_EYE_FFMPEG_VIDEO_PROVIDER_H_
+
+#include <string>
+
+#include "config.h"
+#include "dove_eye/video_provider.h"
+
+#ifdef CONFIG_HAVE_FFMPEG
+
+namespace dove_eye {
+
+/** Video file provider that decodes directly with FFmpeg libraries
+ *
+ * Unlike FileVideoProvider it doesn't go through cv::VideoCapture (thus no
+ * global capture lock nor backend rate limits), decodes with codec's
+ * frame/slice threads and frames carry container's presentation timestamps
+ * (in seconds since stream start).
+ *
+ * Decoded frames are stored in pooled buffers, a buffer is reused once no
+ * frame refers to it.
+ */
+class FfmpegVideoProvider : public VideoProvider {
+ public:
+  explicit FfmpegVideoProvider(const std::string &filename);
+
+  inline std::string Id() const {
+    return filename_;
+  }
+
+  FrameIterator begin() override;
+
+  FrameIterator end() override;
+
+  inline bool Seekable() const override {
+    return true;
+  }
+
+  FrameIterator Seek(const Frame::Timestamp timestamp) override;
+
+ private:
+  const std::string filename_;
+};
+
+} // namespace dove_eye
+
+#endif // CONFIG_HAVE_FFMPEG
+
+#endif // DOVE_EYE_FFMPEG_VIDEO_PROVIDER_H_
@@ -1,16 +1,28 @@
 #ifndef DOVE_EYE_FILE_VIDEO_PROVIDER_H_
 #define DOVE_EYE_FILE_VIDEO_PROVIDER_H_
 
+#include <atomic>
 #include <string>
+#include <thread>
 
+#include <opencv2/opencv.hpp>
+
+#include "dove_eye/frame_index.h"
 #include "dove_eye/video_provider.h"
 
 namespace dove_eye {
 
+/** Video file read through cv::VideoCapture
+ *
+ * Frame index (see FrameIndex) is loaded or built in background since the
+ * provider is created, seeks before it's ready rely on the backend only.
+ */
 class FileVideoProvider : public VideoProvider {
  public:
   explicit FileVideoProvider(const std::string &filename);
 
+  ~FileVideoProvider() override;
+
   inline std::string Id() const {
     return filename_;
   }
@@ -19,8 +31,31 @@ class FileVideoProvider : public VideoProvider {
 
   FrameIterator end() override;
 
+  inline bool Seekable() const override {
+    return true;
+  }
+
+  /**
+   * @note Until the frame index is ready, backend's seek is not verified
+   *       (it may land few frames off for some codecs).
+   */
+  FrameIterator Seek(const Frame::Timestamp timestamp) override;
+
  private:
+  static const int kSeekAttempts = 4;
+
   const std::string filename_;
+
+  /** Written by index_thread_ only until index_ready_ is set */
+  FrameIndex index_;
+  std::atomic<bool> index_ready_;
+  std::atomic<bool> index_cancelled_;
+  std::thread index_thread_;
+
+  void OpenIndex();
+
+  bool SeekCapture(cv::VideoCapture *capture,
+                   const FrameIndex::FrameNo frame_no) const;
 };
 
 } // namespace dove_eye
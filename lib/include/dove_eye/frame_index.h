@@ -0,0 +1,75 @@
+#ifndef DOVE_EYE_FRAME_INDEX_H_
+#define DOVE_EYE_FRAME_INDEX_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "dove_eye/frame.h"
+
+namespace dove_eye {
+
+/** Index of frames in a video file
+ *
+ * Stores presentation timestamps of all frames as reported by the capture
+ * backend. They are used to verify and correct where the backend landed after
+ * seeking (backends seek to the nearest preceding keyframe and their frame
+ * numbering is not always accurate).
+ *
+ * The index is persisted next to the video file, so that it's built only
+ * once.
+ */
+class FrameIndex {
+ public:
+  typedef size_t FrameNo;
+
+  FrameIndex()
+      : file_size_(0) {
+  }
+
+  /** Load index for the video, build and save it when not available
+   *
+   * \param cancel  building stops (nothing is saved) when it's set
+   * \return True when index is ready for use.
+   */
+  bool Open(const std::string &video_filename,
+            const std::atomic<bool> *cancel = nullptr);
+
+  inline bool IsValid() const {
+    return !timestamps_.empty();
+  }
+
+  inline size_t size() const {
+    return timestamps_.size();
+  }
+
+  /** Presentation timestamp of the frame (as reported by backend) */
+  inline Frame::Timestamp Timestamp(const FrameNo frame_no) const {
+    return timestamps_[frame_no];
+  }
+
+  /** Find frame with given presentation timestamp
+   *
+   * \return Frame number of the nearest frame.
+   */
+  FrameNo Find(const Frame::Timestamp timestamp) const;
+
+  static std::string IndexFilename(const std::string &video_filename);
+
+ private:
+  size_t file_size_;
+  std::vector<Frame::Timestamp> timestamps_;
+
+  bool Load(const std::string &filename, const size_t file_size);
+
+  bool Save(const std::string &filename) const;
+
+  bool Build(const std::string &video_filename,
+             const std::atomic<bool> *cancel);
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_FRAME_INDEX_H_
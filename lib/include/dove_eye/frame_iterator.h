@@ -12,6 +12,12 @@ namespace dove_eye {
 /* Forward */
 class VideoProvider;
 
+/** Source of frames for FrameIterator
+ *
+ * When handed over to FrameIterator, implementation must be positioned at the
+ * first frame it delivers (or be invalid), GetFrame() returns the current
+ * frame and MoveNext() advances to the next one.
+ */
 class FrameIteratorImpl {
  public:
   virtual ~FrameIteratorImpl() {}
@@ -33,7 +39,7 @@ class FrameIterator {
                 FrameIteratorImpl *iterator = nullptr)
       : video_provider_(video_provider),
         iterator_(iterator),
-        is_frame_valid_(true) {
+        is_frame_valid_(false) {
   }
 
   Frame operator*() const;
@@ -57,6 +63,7 @@ class FrameIterator {
   const VideoProvider *video_provider_;
   std::shared_ptr<FrameIteratorImpl> iterator_;
 
+  /** Whether frame_ holds the current frame of iterator_ */
   mutable bool is_frame_valid_;
   mutable Frame frame_;
 };
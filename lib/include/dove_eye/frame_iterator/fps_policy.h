@@ -20,6 +20,11 @@ class FpsPolicy {
     return (++frame_no_) * frame_period_;
   }
 
+  /** Next timestamp will belong to the given (zero-based) frame */
+  inline void Seek(const size_t frame_no) {
+    frame_no_ = frame_no;
+  }
+
  private:
   double frame_period_;
   size_t frame_no_;
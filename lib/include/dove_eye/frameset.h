@@ -1,6 +1,8 @@
 #ifndef DOVE_EYE_FRAMESET_H_
 #define DOVE_EYE_FRAMESET_H_
 
+#include <memory>
+
 #include "dove_eye/frame.h"
 #include "dove_eye/tuple.h"
 
@@ -8,14 +10,19 @@ namespace dove_eye {
 
 typedef Tuple<Frame> Frameset;
 
+/** Shared immutable frameset, passing it around doesn't copy the tuple */
+typedef std::shared_ptr<const Frameset> FramesetPtr;
+
 } // namespace dove_eye
 
 #ifdef HAVE_GUI
 /*
  * Make Frameset available as argument for Qt's queued connections.
+ * Prefer FramesetPtr, queued connection then copies the pointer only.
  */
 #include <QMetaType>
 Q_DECLARE_METATYPE(dove_eye::Frameset)
+Q_DECLARE_METATYPE(dove_eye::FramesetPtr)
 #endif
 
 #endif // DOVE_EYE_FRAMESET_H_
@@ -29,6 +29,10 @@ class FramesetAggregator : public Aggregator {
         frame_policy_(providers) {
   }
 
+  size_t Dropped(const CameraIndex cam) const override {
+    return frame_policy_.Dropped(cam);
+  }
+
  private:
   /* Policy must follow Aggregator::parameters_ (because of destruction order) */
   FramePolicy frame_policy_;
@@ -40,6 +44,10 @@ class FramesetAggregator : public Aggregator {
   bool GetFrame(Frame *frame, CameraIndex *cam) override {
     return frame_policy_.GetFrame(frame, cam);
   }
+
+  bool Seek(const TimestampsContainer &timestamps) override {
+    return frame_policy_.Seek(timestamps);
+  }
 };
 
 } // namespace dove_eye
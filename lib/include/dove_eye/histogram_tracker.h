@@ -77,17 +77,11 @@ class HistogramTracker : public SearchingTracker {
   }
 
  private:
-  typedef std::vector<cv::Point> Contour;
-  typedef std::vector<Contour> ContourVector;
-
   HistogramData data_;
 
   cv::Mat PreprocessImage(const cv::Mat &data,
                           const HistogramData &hist_data,
                           cv::Mat *mask) const;
-
-  void ContoursToMark(const ContourVector &contours,
-                        Mark *mark) const;
 };
 
 } // namespace dove_eye
@@ -79,6 +79,41 @@ class InnerTracker {
   /** Track the given frame */
   virtual bool Track(const Frame &frame, Posit *result) = 0;
 
+  /** Track the given frame with externally predicted position
+   *
+   * \param expected   expected position of the object (in the image)
+   * \param deviation  standard deviation of the expected position (x, y)
+   */
+  virtual inline bool Track(const Frame &frame,
+                            const Point2 expected,
+                            const Point2 deviation,
+                            Posit *result) {
+    return Track(frame, result);
+  }
+
+  /** Advance internal prediction without searching the frame
+   *
+   * Used when the frame is skipped, result is the expected position.
+   * @return  false when tracker cannot predict (result is undefined)
+   */
+  virtual inline bool Predict(const Frame &frame, Posit *result) {
+    return false;
+  }
+
+  /** Object was found in the frame by other means (e.g. wrapping tracker)
+   *
+   * Stateful trackers continue their prediction from the posit.
+   */
+  virtual inline void Observe(const Frame &frame, const Posit posit) {
+  }
+
+  /** Extent of the tracked object in the image (width, height)
+   * @return  false when tracker doesn't know it
+   */
+  virtual inline bool ObjectSize(Point2 *size) const {
+    return false;
+  }
+
   /** Global reinitialization */
   virtual bool ReinitializeTracking(const Frame &frame, Posit *result) = 0;
 
@@ -0,0 +1,127 @@
+#ifndef DOVE_EYE_KLT_TRACKER_H_
+#define DOVE_EYE_KLT_TRACKER_H_
+
+#include <memory>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "dove_eye/inner_tracker.h"
+
+namespace dove_eye {
+
+/** Frame-to-frame tracking of sparse features with pyramidal Lucas-Kanade
+ *
+ * Few dozens of corners inside the object are followed by optical flow in a
+ * grey window around the object, the object moves by median of their
+ * displacements. Cost depends on number of features, not on the ROI area.
+ * Features failing forward-backward check or drifting off the object are
+ * dropped and replenished, when too few of them remain the object is lost.
+ *
+ * (Re)initializations are delegated to the fallback (dense) tracker, its
+ * tracker data are exchanged with other cameras too. Fallback observes the
+ * tracked positions so that its prediction is current when reinitializing.
+ */
+class KltTracker : public InnerTracker {
+ public:
+  /** Features needed to estimate the motion at all */
+  static const size_t kMinFeatures = 4;
+
+  KltTracker(const Parameters &parameters, const InnerTracker &fallback);
+
+  KltTracker(const KltTracker &other);
+
+  inline const TrackerData &tracker_data() const override {
+    return fallback_->tracker_data();
+  }
+
+  inline TrackerData &tracker_data() override {
+    return fallback_->tracker_data();
+  }
+
+  bool InitializeTracking(const Frame &frame, const Mark mark,
+                          Posit *result) override;
+
+  bool InitializeTracking(
+      const Frame &frame,
+      const Epiline epiline,
+      const TrackerData &tracker_data,
+      Posit *result) override;
+
+  bool Track(const Frame &frame, Posit *result) override;
+
+  /** Extrapolates with the velocity of the last tracked frames */
+  bool Predict(const Frame &frame, Posit *result) override;
+
+  inline bool ObjectSize(Point2 *size) const override {
+    if (!initialized()) {
+      return false;
+    }
+    *size = Point2(2 * radius_, 2 * radius_);
+    return true;
+  }
+
+  bool ReinitializeTracking(const Frame &frame, Posit *result) override;
+
+  bool ReinitializeTracking(const Frame &frame,
+                            const Epiline epiline,
+                            Posit *result) override;
+
+  bool ReinitializeTracking(const Frame &frame,
+                            const Point2 guess,
+                            Posit *result) override;
+
+  InnerTracker *Clone() const override {
+    assert(!initialized());
+
+    return new KltTracker(*this);
+  }
+
+  inline InnerTracker::Mark::Type PreferredMarkType() const override {
+    return fallback_->PreferredMarkType();
+  }
+
+ private:
+  typedef std::vector<cv::Point2f> FeatureVector;
+
+  std::unique_ptr<InnerTracker> fallback_;
+
+  bool initialized_;
+
+  /** Object extent */
+  double radius_;
+
+  Posit position_;
+  Point2 velocity_;
+  double timestamp_;
+
+  /** Grey image of the last tracked frame in window_ */
+  cv::Rect window_;
+  cv::Mat window_grey_;
+
+  /** Features in window coordinates */
+  FeatureVector features_;
+  size_t seeded_count_;
+
+  inline bool initialized() const  {
+    return initialized_;
+  }
+
+  /** Follow the features from the last frame, the object moves with them */
+  bool TrackFeatures(const Frame &frame, Posit *result);
+
+  /** Restart feature tracking from the posit */
+  void Seed(const Frame &frame, const Posit posit);
+
+  /** Add features of the object up to KLT_FEATURES */
+  void DetectFeatures();
+
+  cv::Rect WindowAround(const cv::Size size, const Posit posit) const;
+
+  void GreyWindow(const cv::Mat &data, const cv::Rect &window,
+                  cv::Mat *grey) const;
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_KLT_TRACKER_H_
@@ -0,0 +1,68 @@
+#ifndef DOVE_EYE_LOCATION_PUBLISHER_H_
+#define DOVE_EYE_LOCATION_PUBLISHER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "dove_eye/frameset.h"
+#include "dove_eye/location.h"
+#include "dove_eye/location_ring.h"
+#include "dove_eye/positset.h"
+#include "dove_eye/types.h"
+
+namespace dove_eye {
+
+/** Publishes tracking results to POSIX shared memory ring
+ *
+ * Other processes read the ring without any locking (see location_ring.h
+ * and tools/location_reader), publishing never blocks on them.
+ *
+ * Open() creates a fresh shared object (old one of the same name is
+ * unlinked), readers have to reopen when publisher is restarted.
+ *
+ * @note Not thread safe, all methods must be called from one thread.
+ */
+class LocationPublisher {
+ public:
+  explicit LocationPublisher(const CameraIndex arity);
+
+  ~LocationPublisher();
+
+  /**
+   * \param name  name of shared memory object, e.g. "/dove_eye_locations"
+   */
+  bool Open(const std::string &name = DOVE_EYE_RING_DEFAULT_NAME);
+
+  void Close();
+
+  inline bool IsOpen() const {
+    return header_ != nullptr;
+  }
+
+  /**
+   * \param location  nullptr when location is not available
+   */
+  void Publish(const Frameset &frameset, const Positset &positset,
+               const Location *location);
+
+  inline CameraIndex Arity() const {
+    return arity_;
+  }
+
+ private:
+  const CameraIndex arity_;
+
+  std::string name_;
+  int fd_;
+  void *map_;
+  size_t map_size_;
+
+  dove_eye_ring_header *header_;
+  dove_eye_ring_slot *slots_;
+
+  uint64_t next_record_;
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_LOCATION_PUBLISHER_H_
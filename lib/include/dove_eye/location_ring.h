@@ -0,0 +1,69 @@
+#ifndef DOVE_EYE_LOCATION_RING_H_
+#define DOVE_EYE_LOCATION_RING_H_
+
+/*
+ * Layout of the shared memory ring with tracking results.
+ *
+ * This header is plain C, it's shared by LocationPublisher and the C reader
+ * library (tools/location_reader).
+ *
+ * Shared object starts with dove_eye_ring_header followed by capacity slots.
+ * Record n is stored in slot n % capacity. Each slot is guarded by its own
+ * sequence counter (seqlock):
+ *   - 2n + 1 while record n is being written,
+ *   - 2n + 2 when record n is complete.
+ * Single producer never waits for readers, a reader that copies a slot while
+ * it's being overwritten detects it by the changed counter and skips it.
+ *
+ * Counters must be accessed atomically (acquire/release), all other fields
+ * are plain data. All fields are in host byte order.
+ */
+
+#include <stdint.h>
+
+#define DOVE_EYE_RING_MAGIC 0x52594544u /* "DEYR" */
+#define DOVE_EYE_RING_VERSION 1u
+#define DOVE_EYE_RING_CAPACITY 256u
+#define DOVE_EYE_RING_MAX_ARITY 8u
+#define DOVE_EYE_RING_DEFAULT_NAME "/dove_eye_locations"
+
+/** Flags of dove_eye_ring_record */
+#define DOVE_EYE_RING_LOCATION_VALID 0x1u
+
+struct dove_eye_ring_record {
+  /** Number of the record since the publisher was opened */
+  uint64_t record_no;
+  /** Frameset sequence number */
+  uint64_t sequence_no;
+  /** Capture timestamp (latest frame of the frameset) [s] */
+  double timestamp;
+  /** CLOCK_MONOTONIC time of publishing [s] */
+  double publish_time;
+  uint32_t flags;
+  uint32_t arity;
+  /** Bit cam is set when posits[cam] is valid */
+  uint32_t posit_validity;
+  uint32_t reserved;
+  /** 3D location (x, y, z), valid with DOVE_EYE_RING_LOCATION_VALID */
+  float location[3];
+  float reserved2;
+  /** Image coordinates (x, y) of tracked object in each camera */
+  float posits[DOVE_EYE_RING_MAX_ARITY][2];
+};
+
+struct dove_eye_ring_slot {
+  uint64_t seq;
+  struct dove_eye_ring_record record;
+};
+
+struct dove_eye_ring_header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity;
+  uint32_t slot_size;
+  /** No. of published records (written by producer only) */
+  uint64_t head;
+  uint64_t reserved[5];
+};
+
+#endif /* DOVE_EYE_LOCATION_RING_H_ */
@@ -1,26 +1,196 @@
 #ifndef DOVE_EYE_LOGGING_H_
 #define DOVE_EYE_LOGGING_H_
 
-#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #ifdef WIN32
 #define __func__ __FUNCTION__
 #endif
 
-//TODO Replace "\n" with platform independent constant
-#ifndef NDEBUG
-#define DEBUG(...) do {              \
-  fprintf(stderr , __VA_ARGS__);     \
-  fprintf(stderr, "\n");             \
+#ifdef __GNUC__
+#define DOVE_EYE_PRINTF_FORMAT(fmt, args) \
+  __attribute__((format(printf, fmt, args)))
+#else
+#define DOVE_EYE_PRINTF_FORMAT(fmt, args) /* empty */
+#endif
+
+namespace dove_eye {
+
+enum LogLevel {
+  kLogDebug,
+  kLogInfo,
+  kLogWarning,
+  kLogError,
+  kLogOff
+};
+
+/** Logging statement in the source, each call site has a static instance
+ *
+ * Site caches whether its module passes the current filter, so disabled
+ * statements cost only two atomic loads and no formatting.
+ * Module is the basename of the source file (e.g. 'template_tracker').
+ */
+class LogSite {
+ public:
+  LogSite(const char *file, const int line, const LogLevel level);
+
+  inline bool ShouldLog() {
+    if (version_.load(std::memory_order_relaxed) != config_version_) {
+      Refresh();
+    }
+    return enabled_.load(std::memory_order_relaxed) && Admit();
+  }
+
+  /** Number of messages suppressed by rate limit since the last call */
+  inline unsigned TakeSuppressed() {
+    return suppressed_.exchange(0, std::memory_order_relaxed);
+  }
+
+  inline int line() const {
+    return line_;
+  }
+
+  inline LogLevel level() const {
+    return level_;
+  }
+
+ private:
+  friend class Logger;
+
+  /** Bumped by every Logger::Configure() */
+  static std::atomic<unsigned> config_version_;
+
+  /** Points into __FILE__, valid until the very end of the process */
+  const char *module_;
+  int module_length_;
+  const int line_;
+  const LogLevel level_;
+
+  std::atomic<unsigned> version_;
+  std::atomic<bool> enabled_;
+
+  std::atomic<int64_t> window_;
+  std::atomic<unsigned> window_count_;
+  std::atomic<unsigned> suppressed_;
+
+  void Refresh();
+
+  /** Rate limit, at most Logger's rate messages per second */
+  bool Admit();
+};
+
+class LogRing;
+
+/** Asynchronous logger
+ *
+ * Logging threads format messages into their own lock-free ring buffer,
+ * a background thread merges the rings and writes them to stderr, so camera
+ * threads neither contend for stderr nor wait for the terminal. When the ring
+ * is full, messages are dropped (and counted) rather than blocking the caller.
+ * Errors wake the writer immediately, other levels are written within
+ * kFlushPeriod.
+ *
+ * Filter is read from environment variable DOVE_EYE_LOG (see Configure()).
+ */
+class Logger {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  static const std::chrono::milliseconds kFlushPeriod;
+
+  static const unsigned kDefaultRate = 10;
+
+  /** Logger is never destroyed, static destructors may log too */
+  static Logger &Instance();
+
+  /** Sets filter from comma separated specification
+   *
+   * Items are a default level ('debug', 'info', 'warning', 'error', 'off'),
+   * module levels ('template_tracker=off') and per site rate limit in
+   * messages per second ('rate=10', 0 for unlimited), e.g.
+   * "info,tracker=debug,rate=5".
+   *
+   * \return false when the specification is invalid (nothing changes)
+   */
+  bool Configure(const std::string &spec);
+
+  void Log(LogSite *site, const char *format, ...)
+      DOVE_EYE_PRINTF_FORMAT(3, 4);
+
+  /** Synchronously write all pending messages */
+  void Flush();
+
+  /** Stop the writer thread, later messages are written synchronously
+   *
+   * Called automatically at exit.
+   */
+  void Shutdown();
+
+ private:
+  friend class LogSite;
+
+  typedef std::unique_lock<std::mutex> Lock;
+  typedef std::vector<std::shared_ptr<LogRing>> RingVector;
+
+  const Clock::time_point start_;
+
+  mutable std::mutex config_mtx_;
+  LogLevel default_level_;
+  std::map<std::string, LogLevel> module_levels_;
+  std::atomic<unsigned> rate_;
+
+  std::mutex rings_mtx_;
+  RingVector rings_;
+  unsigned next_thread_no_;
+
+  /** Serializes drains (writer thread vs. Flush()) */
+  std::mutex write_mtx_;
+
+  std::thread writer_;
+  std::atomic<bool> stopped_;
+  bool stop_requested_;
+  std::mutex writer_mtx_;
+  std::condition_variable writer_cv_;
+
+  Logger();
+
+  LogLevel ModuleLevel(const std::string &module) const;
+
+  LogRing *ThreadRing();
+
+  void WriterLoop();
+
+  void Drain();
+};
+
+} // namespace dove_eye
+
+#define DOVE_EYE_LOG(level, ...) do {                                   \
+  static ::dove_eye::LogSite dove_eye_log_site(__FILE__, __LINE__, level); \
+  if (dove_eye_log_site.ShouldLog()) {                                  \
+    ::dove_eye::Logger::Instance().Log(&dove_eye_log_site, __VA_ARGS__); \
+  }                                                                     \
 } while (false)
+
+#ifndef NDEBUG
+#define DEBUG(...) DOVE_EYE_LOG(::dove_eye::kLogDebug, __VA_ARGS__)
 #else
 #define DEBUG(...) /* empty */
 #endif
 
-#define ERROR(...) do {              \
-  fprintf(stderr , __VA_ARGS__);     \
-  fprintf(stderr, "\n");             \
-} while (false)
+#define INFO(...) DOVE_EYE_LOG(::dove_eye::kLogInfo, __VA_ARGS__)
 
-#endif // DOVE_EYE_LOGGING_H_
+#define WARNING(...) DOVE_EYE_LOG(::dove_eye::kLogWarning, __VA_ARGS__)
 
+#define ERROR(...) DOVE_EYE_LOG(::dove_eye::kLogError, __VA_ARGS__)
+
+#endif // DOVE_EYE_LOGGING_H_
@@ -0,0 +1,147 @@
+#ifndef DOVE_EYE_METRICS_H_
+#define DOVE_EYE_METRICS_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dove_eye/types.h"
+
+namespace dove_eye {
+
+/** Monotonic counter, updates are lock-free */
+class Counter {
+ public:
+  Counter()
+      : value_(0) {
+  }
+
+  inline void Add(const uint64_t value = 1) {
+    value_.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  inline uint64_t Value() const {
+    return value_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<uint64_t> value_;
+};
+
+/** Current value of a quantity, updates are lock-free */
+class Gauge {
+ public:
+  Gauge()
+      : value_(0) {
+  }
+
+  inline void Set(const double value) {
+    value_.store(value, std::memory_order_relaxed);
+  }
+
+  inline double Value() const {
+    return value_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<double> value_;
+};
+
+/** Process-wide registry of runtime metrics
+ *
+ * Metrics are identified by name and labels (Prometheus style, e.g.
+ * 'cam="0"'). Registration takes a lock, so components look their metrics up
+ * once and keep the returned reference, it's valid until the end of the
+ * process. Metrics of re-created components (e.g. new pipeline) continue
+ * with the same instances.
+ *
+ * Snapshot can be written in Prometheus text format, periodically to a file
+ * too (see StartDump()).
+ */
+class Metrics {
+ public:
+  enum Type {
+    kCounter,
+    kGauge
+  };
+
+  struct Sample {
+    std::string name;
+    std::string labels;
+    Type type;
+    double value;
+  };
+
+  typedef std::vector<Sample> SampleVector;
+
+  static Metrics &Instance();
+
+  ~Metrics();
+
+  Counter &GetCounter(const std::string &name, const std::string &labels,
+                      const std::string &help);
+
+  Gauge &GetGauge(const std::string &name, const std::string &labels,
+                  const std::string &help);
+
+  /** Current values of all metrics, ordered by name and labels */
+  SampleVector Samples() const;
+
+  void WritePrometheus(std::ostream &out) const;
+
+  /** Write to temporary file and rename it over filename
+   *
+   * Readers (scrapers) never see a partially written file.
+   */
+  bool WriteFile(const std::string &filename) const;
+
+  /** Periodically write metrics to the file from a background thread
+   *
+   * \param interval  seconds
+   */
+  void StartDump(const std::string &filename, const double interval);
+
+  void StopDump();
+
+  /** Label string for a camera */
+  static std::string CamLabel(const CameraIndex cam);
+
+ private:
+  struct Entry {
+    Type type;
+    std::string name;
+    std::string labels;
+    std::unique_ptr<Counter> counter;
+    std::unique_ptr<Gauge> gauge;
+  };
+
+  typedef std::map<std::string, Entry> EntryMap;
+  typedef std::unique_lock<std::mutex> Lock;
+
+  mutable std::mutex mtx_;
+  EntryMap entries_;
+  std::map<std::string, std::string> helps_;
+
+  std::thread dump_thread_;
+  bool dump_stop_requested_;
+  std::mutex dump_mtx_;
+  std::condition_variable dump_cv_;
+
+  Metrics();
+
+  Entry &GetEntry(const Type type, const std::string &name,
+                  const std::string &labels, const std::string &help);
+
+  void DumpLoop(const std::string filename, const double interval);
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_METRICS_H_
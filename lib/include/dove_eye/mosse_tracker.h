@@ -0,0 +1,115 @@
+#ifndef DOVE_EYE_MOSSE_TRACKER_H_
+#define DOVE_EYE_MOSSE_TRACKER_H_
+
+#include <opencv2/opencv.hpp>
+
+#include "dove_eye/searching_tracker.h"
+
+namespace dove_eye {
+
+/** Tracks object with adaptive correlation filter (MOSSE)
+ *
+ * Filter is learned in the frequency domain from grey patches around the
+ * object (log transformed, normalized, cosine windowed), the numerator and
+ * denominator of the filter are running averages over the tracked frames.
+ * Response peak is the object position, match is scored by its
+ * peak-to-sidelobe ratio (PSR).
+ *
+ * ROI fitting into the filter is searched with one forward and one inverse
+ * DFT, larger regions (global and epiline search) are correlated with the
+ * spatial kernel of the filter.
+ */
+class MosseTracker : public SearchingTracker {
+ public:
+  struct FilterData : public TrackerData {
+    /** Filter size (DFT friendly) */
+    cv::Size size;
+    /** Extent of the object */
+    double radius;
+
+    /** Cosine window of the filter size */
+    cv::Mat window;
+    /** Spectrum of desired response (Gaussian peak) */
+    cv::Mat response;
+
+    /** Running averages, spectrum and real power spectrum */
+    cv::Mat numerator;
+    cv::Mat denominator;
+
+    /** Spectrum of the filter (numerator / denominator) */
+    cv::Mat filter;
+    /** Filter in the image domain, for correlation of large regions */
+    cv::Mat kernel;
+
+    FilterData()
+        : radius(0) {
+    }
+  };
+
+  /** Filter extent relative to the object */
+  static const double kPadding;
+
+  explicit MosseTracker(const Parameters &parameters)
+      : SearchingTracker(parameters) {
+  }
+
+  inline const TrackerData &tracker_data() const override {
+    return data_;
+  }
+
+  inline TrackerData &tracker_data() override {
+    return data_;
+  }
+
+  InnerTracker *Clone() const override {
+    assert(!initialized());
+
+    return new MosseTracker(*this);
+  }
+
+  inline InnerTracker::Mark::Type PreferredMarkType() const override {
+    return InnerTracker::Mark::kCircle;
+  }
+
+ protected:
+  bool InitTrackerData(const cv::Mat &data, const Mark &mark) override;
+
+  bool Search(
+      const cv::Mat &data,
+      TrackerData &tracker_data,
+      const cv::Rect *roi,
+      const cv::Mat *mask,
+      const double threshold,
+      Mark *result) const override;
+
+  void UpdateTrackerData(const cv::Mat &data, const Mark &match) override;
+
+  inline Posit MarkToPosit(const Mark &mark) const override {
+    if (mark.type == Mark::kRectangle) {
+      return mark.top_left + 0.5 * mark.size;
+    }
+    assert(mark.type == Mark::kCircle);
+    return mark.center;
+  }
+
+  inline cv::Rect DataToRoi(const TrackerData &tracker_data, const Point2 exp,
+                            const double search_factor) const override {
+    const auto f = search_factor;
+    const auto &data = static_cast<const FilterData &>(tracker_data);
+    return cv::Rect(exp.x - f * data.radius, exp.y - f * data.radius,
+                    2 * f * data.radius, 2 * f * data.radius);
+  }
+
+ private:
+  FilterData data_;
+
+  /** Recompute filter and kernel from the running averages */
+  void UpdateFilter(FilterData *filter_data) const;
+
+  /** PSR mapped to [0, 1), MOSSE_PSR scores 0.5 */
+  double Score(const double psr) const;
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_MOSSE_TRACKER_H_
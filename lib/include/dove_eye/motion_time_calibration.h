@@ -0,0 +1,104 @@
+#ifndef DOVE_EYE_MOTION_TIME_CALIBRATION_H_
+#define DOVE_EYE_MOTION_TIME_CALIBRATION_H_
+
+#include <deque>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "dove_eye/frame.h"
+#include "dove_eye/frameset.h"
+#include "dove_eye/parameters.h"
+#include "dove_eye/types.h"
+
+namespace dove_eye {
+
+/** Estimate time offsets between cameras from observed motion
+ *
+ * Each camera contributes a cheap motion-energy signal (mean absolute
+ * difference of consecutive downsampled grayscale frames). Signals are
+ * resampled to a uniform grid and cross-correlated (via FFT) with the signal
+ * of the first camera, the correlation peak is refined with a parabola to
+ * obtain sub-frame offsets.
+ *
+ * Frameset timestamps already have current CAM_OFFSET subtracted, thus the
+ * estimate is a residual that is added to current offsets. Offsets are
+ * normalized so that the earliest camera has zero offset.
+ *
+ * The estimation is repeated for each window, so it can run continuously.
+ */
+class MotionTimeCalibration {
+ public:
+  typedef Frame::Timestamp ResultType;
+
+  enum MeasurementState {
+    kUnitialized,
+    kCollecting,
+    kReady
+  };
+
+  MotionTimeCalibration(Parameters &parameters, const CameraIndex arity);
+
+  /** Collect motion samples from frameset
+   *
+   * When enough data is collected, offsets are estimated and written into
+   * parameters.
+   *
+   * \return True when new offsets were estimated and stored.
+   */
+  bool MeasureFrameset(const Frameset &frameset);
+
+  void Reset();
+
+  /** Absolute offset of the camera from the last successful estimation */
+  ResultType Result(const CameraIndex cam) const;
+
+  inline CameraIndex Arity() const {
+    return arity_;
+  }
+
+  inline MeasurementState state() const {
+    return state_;
+  }
+
+ private:
+  struct Sample {
+    Frame::Timestamp timestamp;
+    double energy;
+  };
+
+  typedef std::deque<Sample> SampleQueue;
+
+  /** Width of image used for computing motion energy */
+  static const int kSignalWidth = 80;
+
+  Parameters &parameters_;
+
+  const CameraIndex arity_;
+
+  MeasurementState state_;
+
+  std::vector<SampleQueue> samples_;
+  std::vector<cv::Mat> previous_;
+  std::vector<ResultType> result_;
+
+  bool MotionEnergy(const CameraIndex cam, const cv::Mat &data,
+                    double *energy);
+
+  bool Estimate(const Frame::Timestamp start, const Frame::Timestamp end);
+
+  void Resample(const SampleQueue &samples,
+                const Frame::Timestamp start,
+                const double rate,
+                const int length,
+                cv::Mat *signal) const;
+
+  bool CrossCorrelate(const cv::Mat &signal,
+                      const cv::Mat &reference,
+                      const double min_correlation,
+                      double *lag) const;
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_MOTION_TIME_CALIBRATION_H_
@@ -2,9 +2,12 @@
 #define DOVE_EYE_PARAMETERS_H_
 
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "config.h"
 
@@ -23,11 +26,28 @@ class Parameters {
  public:
   enum Key {
     DECLARE_PARAM(TEMPLATE_RADIUS) = 0,
+    DECLARE_PARAM(TEMPLATE_COUNT),
+    DECLARE_PARAM(TEMPLATE_UPDATE),
     DECLARE_PARAM(SEARCH_FACTOR),
+    DECLARE_PARAM(SEARCH_MIN_FACTOR),
+    DECLARE_PARAM(SEARCH_SIGMA),
     DECLARE_PARAM(SEARCH_THRESHOLD),
     DECLARE_PARAM(SEARCH_MIN_SPEED),
     DECLARE_PARAM(SEARCH_KF_PROC_V),
     DECLARE_PARAM(SEARCH_KF_OBS_V),
+    DECLARE_PARAM(KLT_FEATURES),
+    DECLARE_PARAM(KLT_WINDOW),
+    DECLARE_PARAM(KLT_LEVELS),
+    DECLARE_PARAM(KLT_MIN_RATIO),
+    DECLARE_PARAM(KLT_FB_ERROR),
+    DECLARE_PARAM(MOSSE_RATE),
+    DECLARE_PARAM(MOSSE_SIGMA),
+    DECLARE_PARAM(MOSSE_PSR),
+    DECLARE_PARAM(FUSED_KF_PROC_V),
+    DECLARE_PARAM(FUSED_KF_OBS_V),
+    DECLARE_PARAM(DECIMATION_MAX),
+    DECLARE_PARAM(DECIMATION_MOTION),
+    DECLARE_PARAM(TRACK_BUDGET),
     DECLARE_PARAM(AGGREGATOR_WINDOW),
     DECLARE_PARAM_ARRAY(CAM_OFFSET, CONFIG_MAX_ARITY),
     DECLARE_PARAM(CALIBRATION_ROWS),
@@ -35,6 +55,12 @@ class Parameters {
     DECLARE_PARAM(CALIBRATION_SIZE),
     DECLARE_PARAM(CALIBRATION_FRAMES),
     DECLARE_PARAM(CALIBRATION_SKIP),
+    DECLARE_PARAM(TIMECALIB_WINDOW),
+    DECLARE_PARAM(TIMECALIB_RATE),
+    DECLARE_PARAM(TIMECALIB_MIN_CORRELATION),
+    DECLARE_PARAM(PREVIEW_WIDTH),
+    DECLARE_PARAM(PREVIEW_RATE),
+    DECLARE_PARAM(METRICS_INTERVAL),
     _MAX_KEY
   };
 
@@ -42,12 +68,57 @@ class Parameters {
     Key key;
     Key last_key;
     std::string name;
+    /** Default value */
     double value;
     std::string unit;
     double min_value;
     double max_value;
   };
 
+  /** Immutable set of all parameter values
+   *
+   * Readers should obtain a snapshot once (e.g. per frameset) and read all
+   * values from it, they'll see consistent values and take no lock.
+   * Snapshot is valid as long as the Parameters it was taken from.
+   */
+  class Snapshot {
+   public:
+    /** Empty snapshot, only to be assigned to */
+    Snapshot()
+        : values_(nullptr) {
+    }
+
+    inline double Get(const Key key) const {
+      assert(values_);
+      assert(key < _MAX_KEY);
+      return values_->values[key];
+    }
+
+    inline double Get(const Key key, const size_t offset) const {
+      return Get(static_cast<Key>(static_cast<size_t>(key) + offset));
+    }
+
+    /** Snapshots published later have greater version */
+    inline size_t version() const {
+      assert(values_);
+      return values_->version;
+    }
+
+   private:
+    friend class Parameters;
+
+    struct Values {
+      size_t version;
+      std::array<double, _MAX_KEY> values;
+    };
+
+    explicit Snapshot(const Values *values)
+        : values_(values) {
+    }
+
+    const Values *values_;
+  };
+
   class iterator {
    public:
     explicit iterator(const size_t key, const Parameters &parameters)
@@ -86,16 +157,42 @@ class Parameters {
     return iterator(static_cast<size_t>(_MAX_KEY), *this);
   }
 
-  double Get(const Key key) const;
+  /** Current snapshot of values
+   *
+   * Single atomic load of the published values, readers don't write any
+   * shared memory and don't wait for writers.
+   */
+  inline Snapshot snapshot() const {
+    return Snapshot(values_.load(std::memory_order_acquire));
+  }
 
-  double Get(const Key key, const size_t offset) const;
+  inline double Get(const Key key) const {
+    return snapshot().Get(key);
+  }
+
+  inline double Get(const Key key, const size_t offset) const {
+    return snapshot().Get(key, offset);
+  }
 
+  /** Publish a new snapshot with changed value
+   *
+   * @note Replaced values are freed with Parameters only (snapshots don't
+   *       count references), setting the current value publishes nothing.
+   */
   bool Set(const Key key, const double value);
 
  private:
-  mutable std::mutex parameters_mtx_;
-  /** Actual parameters */
+  typedef std::unique_ptr<const Snapshot::Values> ValuesPtr;
+
+  /** Serializes writers, guards published_ */
+  std::mutex writers_mtx_;
+  /** Parameter definitions (their value is the default) */
   std::array<Parameter, _MAX_KEY> parameters_;
+
+  /** All values ever published, the last ones are current */
+  std::vector<ValuesPtr> published_;
+  /** Current values */
+  std::atomic<const Snapshot::Values *> values_;
 };
 
 } // namespace dove_eye
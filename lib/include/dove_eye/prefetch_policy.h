@@ -0,0 +1,195 @@
+#ifndef DOVE_EYE_PREFETCH_POLICY_H_
+#define DOVE_EYE_PREFETCH_POLICY_H_
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dove_eye/frame.h"
+#include "dove_eye/types.h"
+#include "dove_eye/video_provider.h"
+
+
+namespace dove_eye {
+
+/** Frame policy with same output as BlockingPolicy, decoding in advance
+ *
+ * Each provider is read by its own thread into a bounded look-ahead queue.
+ * Consumer round-robins over the queues (skipping finished providers), thus
+ * frames come in the same order as with BlockingPolicy, none is dropped.
+ */
+class PrefetchPolicy {
+ public:
+  typedef std::vector<VideoProvider *> ProvidersContainer;
+
+  explicit PrefetchPolicy(const ProvidersContainer &providers)
+      : providers_(providers),
+        current_cam_(0),
+        initialized_(false),
+        threads_(providers_.size()),
+        channels_(providers_.size()),
+        stop_requested_(false) {
+  }
+
+  ~PrefetchPolicy() {
+    StopThreads();
+  }
+
+  void Start() {
+    if (initialized_ || providers_.size() == 0) {
+      return;
+    }
+
+    Iterators iterators;
+    for (auto provider : providers_) {
+      iterators.push_back(provider->begin());
+    }
+    StartThreads(iterators);
+    initialized_ = true;
+  }
+
+  bool GetFrame(Frame *frame, CameraIndex *cam) {
+    assert(initialized_);
+
+    int attempts = 0;
+    while (attempts < providers_.size()) {
+      auto &channel = channels_[current_cam_];
+      Lock lock(channel.mtx);
+      channel.cv.wait(lock, [&] {
+                        return !channel.queue.empty() || channel.finished;
+                      });
+
+      if (!channel.queue.empty()) {
+        *frame = channel.queue.front();
+        *cam = current_cam_;
+        channel.queue.pop_front();
+        channel.cv.notify_all();
+
+        /* round-robin on cameras */
+        current_cam_ = (current_cam_ + 1) % providers_.size();
+        return true;
+      }
+
+      /* Provider finished, try next one. */
+      current_cam_ = (current_cam_ + 1) % providers_.size();
+      attempts += 1;
+    }
+
+    /* All providers finished. */
+    return false;
+  }
+
+  /** Frames are never dropped */
+  inline size_t Dropped(const CameraIndex cam) const {
+    return 0;
+  }
+
+  bool Seek(const std::vector<Frame::Timestamp> &timestamps) {
+    assert(initialized_);
+    assert(timestamps.size() == providers_.size());
+
+    for (auto provider : providers_) {
+      if (!provider->Seekable()) {
+        return false;
+      }
+    }
+
+    StopThreads();
+
+    Iterators iterators;
+    for (int i = 0; i < providers_.size(); ++i) {
+      iterators.push_back(providers_[i]->Seek(timestamps[i]));
+    }
+    current_cam_ = 0;
+    StartThreads(iterators);
+
+    return true;
+  }
+
+ private:
+  typedef std::vector<FrameIterator> Iterators;
+  typedef std::vector<std::thread> ThreadContainer;
+  typedef std::unique_lock<std::mutex> Lock;
+
+  /** Decoded frames of a single provider */
+  struct Channel {
+    std::deque<Frame> queue;
+    bool finished = false;
+    std::mutex mtx;
+    std::condition_variable cv;
+  };
+
+  static const size_t kLookAhead = 8;
+
+  ProvidersContainer providers_;
+  CameraIndex current_cam_;
+  bool initialized_;
+
+  ThreadContainer threads_;
+  std::vector<Channel> channels_;
+  std::atomic<bool> stop_requested_;
+
+  void StartThreads(const Iterators &iterators) {
+    stop_requested_ = false;
+
+    for (CameraIndex cam = 0; cam < providers_.size(); ++cam) {
+      auto &channel = channels_[cam];
+      channel.queue.clear();
+      channel.finished = false;
+
+      threads_[cam] = std::thread(&PrefetchPolicy::ReadProvider, this, cam,
+                                  iterators[cam]);
+    }
+  }
+
+  void StopThreads() {
+    stop_requested_ = true;
+    for (auto &channel : channels_) {
+      Lock lock(channel.mtx);
+      channel.cv.notify_all();
+    }
+
+    for (auto &thread : threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+  void ReadProvider(const CameraIndex cam, FrameIterator iterator) {
+    auto &channel = channels_[cam];
+    auto end = providers_[cam]->end();
+
+    for (; iterator != end && !stop_requested_; ++iterator) {
+      /* Decode outside of the lock */
+      Frame frame = *iterator;
+
+      Lock lock(channel.mtx);
+      channel.cv.wait(lock, [&] {
+                        return channel.queue.size() < kLookAhead ||
+                            stop_requested_;
+                      });
+      if (stop_requested_) {
+        break;
+      }
+
+      channel.queue.push_back(frame);
+      channel.cv.notify_all();
+    }
+
+    {
+      Lock lock(channel.mtx);
+      channel.finished = true;
+      channel.cv.notify_all();
+    }
+  }
+};
+
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_PREFETCH_POLICY_H_
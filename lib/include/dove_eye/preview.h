@@ -0,0 +1,62 @@
+#ifndef DOVE_EYE_PREVIEW_H_
+#define DOVE_EYE_PREVIEW_H_
+
+#include <chrono>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "dove_eye/frameset.h"
+#include "dove_eye/parameters.h"
+#include "dove_eye/types.h"
+
+namespace dove_eye {
+
+/** Area downscale by integer factor and convert to RGB in a single pass
+ *
+ * Accepts 8-bit BGR or grayscale input, output is 8-bit RGB with dimensions
+ * src / factor (truncated). Inner loops operate on contiguous rows so that
+ * they're vectorized by the compiler.
+ *
+ * \param factor  1..PreviewGenerator::kMaxFactor
+ */
+void DownscaleToRgb(const cv::Mat &src, const int factor, cv::Mat *dst);
+
+/** Produces low-resolution display copies of delivered framesets
+ *
+ * Runs on the consumer side, previews thus show frames that went through the
+ * processing loop (and marks drawn over them apply to those frames). Previews
+ * are made at most PREVIEW_RATE times per second (wall-clock time), Delay()
+ * tells the consumer when to convert its latest frameset instead of dropping
+ * it. Camera without a valid frame keeps its last preview.
+ */
+class PreviewGenerator {
+ public:
+  static const int kMaxFactor = 16;
+
+  PreviewGenerator(const Parameters &parameters, const CameraIndex arity);
+
+  /** Time until the next preview is due
+   * @return  seconds, zero when due now
+   */
+  double Delay() const;
+
+  void Process(const Frameset &frameset);
+
+  /** Last preview of the camera, empty when none was made */
+  inline const cv::Mat &preview(const CameraIndex cam) const {
+    return previews_[cam];
+  }
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  const Parameters &parameters_;
+
+  Clock::time_point last_process_;
+  std::vector<cv::Mat> previews_;
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_PREVIEW_H_
@@ -0,0 +1,132 @@
+#ifndef DOVE_EYE_RECORDER_H_
+#define DOVE_EYE_RECORDER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dove_eye/frameset.h"
+#include "dove_eye/inner_tracker.h"
+#include "dove_eye/parameters.h"
+#include "dove_eye/recording_format.h"
+#include "dove_eye/types.h"
+
+namespace dove_eye {
+
+/** Sink that writes framesets to per-camera stream files
+ *
+ * Writing is done by a dedicated I/O thread with large buffered sequential
+ * writes. Record() never waits for the disk, when the writer falls behind
+ * (bounded queue is full) the frameset is dropped and counted.
+ *
+ * Stored timestamps are capture timestamps (CAM_OFFSET is added back), so
+ * replaying through the aggregator with the same offsets yields the same
+ * alignment.
+ *
+ * Along with streams, pipeline log (see recording::LogFilename) describes
+ * every frameset, capture drops, marks and parameter changes, so that the
+ * session can be replayed through the tracker exactly. Log lines are
+ * formatted in caller's thread and written by the I/O thread too.
+ */
+class Recorder {
+ public:
+  Recorder(const Parameters &parameters, const CameraIndex arity);
+
+  ~Recorder();
+
+  /**
+   * \param basename  stream files are named by recording::StreamFilename
+   */
+  bool Start(const std::string &basename,
+             const recording::Codec codec = recording::kRaw);
+
+  /** Write remaining queued framesets and close files */
+  void Stop();
+
+  inline bool IsRecording() const {
+    return recording_;
+  }
+
+  /** Queue valid frames of frameset for writing, never blocks
+   *
+   * Frameset is logged even when it's dropped.
+   */
+  void Record(const Frameset &frameset);
+
+  /** Log the mark that is set on frameset (before Record() of it) */
+  void RecordMark(const size_t sequence_no, const CameraIndex cam,
+                  const InnerTracker::Mark &mark, const bool project_other);
+
+  /**
+   * \param total  frames of the camera dropped by capture since its start,
+   *               only increase is logged
+   */
+  void RecordDropped(const CameraIndex cam, const size_t total);
+
+  inline size_t recorded() const {
+    return recorded_;
+  }
+
+  inline size_t dropped() const {
+    return dropped_;
+  }
+
+  inline CameraIndex Arity() const {
+    return arity_;
+  }
+
+ private:
+  typedef std::unique_lock<std::mutex> Lock;
+
+  static const size_t kQueueSize = 32;
+  static const size_t kBufferSize = 8 << 20;
+  static const size_t kUnknownDropped = static_cast<size_t>(-1);
+
+  const Parameters &parameters_;
+
+  const CameraIndex arity_;
+
+  recording::Codec codec_;
+
+  std::atomic<bool> recording_;
+  std::atomic<size_t> recorded_;
+  std::atomic<size_t> dropped_;
+
+  std::vector<FILE *> files_;
+  std::vector<std::vector<char>> buffers_;
+  FILE *log_file_;
+
+  /* Accessed by caller's thread only */
+  std::vector<size_t> last_dropped_;
+  bool has_parameters_;
+  Parameters::Snapshot last_parameters_;
+
+  std::thread writer_;
+  bool stop_requested_;
+  std::deque<Frameset> queue_;
+  /** Log lines not written yet */
+  std::string log_;
+  std::mutex queue_mtx_;
+  std::condition_variable queue_cv_;
+
+  void WriteLoop();
+
+  /** Append line to log, it's written by I/O thread */
+  void Log(const char *format, ...);
+
+  /** Log parameters changed since the last call */
+  void LogParameters(const size_t sequence_no);
+
+  bool WriteFrame(const CameraIndex cam, const Frame &frame);
+
+  void CloseFiles();
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_RECORDER_H_
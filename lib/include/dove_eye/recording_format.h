@@ -0,0 +1,79 @@
+#ifndef DOVE_EYE_RECORDING_FORMAT_H_
+#define DOVE_EYE_RECORDING_FORMAT_H_
+
+#include <cstdint>
+#include <string>
+
+#include "dove_eye/types.h"
+
+namespace dove_eye {
+namespace recording {
+
+/*
+ * Recording consists of one stream file per camera, a stream file starts
+ * with FileHeader followed by frames. Each frame is a FrameHeader followed by
+ * size bytes of payload (raw pixel rows or encoded image).
+ *
+ * All fields are in host byte order.
+ */
+
+enum Codec : uint32_t {
+  kRaw = 0,
+  kPng = 1
+};
+
+const char kMagic[8] = {'D', 'O', 'V', 'E', 'R', 'E', 'C', '1'};
+
+struct FileHeader {
+  char magic[8];
+  uint32_t codec;
+  uint32_t reserved;
+};
+
+struct FrameHeader {
+  double timestamp;
+  int32_t rows;
+  int32_t cols;
+  int32_t type;
+  uint32_t reserved;
+  uint64_t size;
+};
+
+const char kStreamExtension[] = ".dvr";
+
+inline std::string StreamFilename(const std::string &basename,
+                                  const CameraIndex cam) {
+  return basename + ".cam" + std::to_string(cam) + kStreamExtension;
+}
+
+/*
+ * Pipeline log is a text file recorded along with streams, it describes
+ * inputs of the pipeline so that tracking can be replayed deterministically.
+ * Lines are in order of events, fields are separated by a space:
+ *
+ *   # comment
+ *   A arity
+ *   P sequence_no name value
+ *       parameter value valid from the frameset on (all parameters are
+ *       logged before the first frameset, then changes only)
+ *   D cam count
+ *       frames dropped by capture of the camera since previous D line
+ *   M sequence_no cam project_other type cx cy radius x y width height
+ *       mark set on the frameset (before it's tracked), see InnerTracker::Mark
+ *   F sequence_no written t0 t1 ...
+ *       frameset passed to the pipeline, ti is timestamp of camera's frame
+ *       (as seen by tracker, i.e. with CAM_OFFSET applied) or '-' when the
+ *       frame is not valid, written is 0 when recorder dropped the frameset
+ *       (its frames are missing in streams)
+ */
+
+const char kLogExtension[] = ".log";
+
+inline std::string LogFilename(const std::string &basename) {
+  return basename + kLogExtension;
+}
+
+} // namespace recording
+} // namespace dove_eye
+
+#endif // DOVE_EYE_RECORDING_FORMAT_H_
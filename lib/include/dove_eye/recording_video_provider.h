@@ -0,0 +1,35 @@
+#ifndef DOVE_EYE_RECORDING_VIDEO_PROVIDER_H_
+#define DOVE_EYE_RECORDING_VIDEO_PROVIDER_H_
+
+#include <string>
+
+#include "dove_eye/video_provider.h"
+
+namespace dove_eye {
+
+/** Replays a stream file written by Recorder
+ *
+ * Frames carry original (capture) timestamps.
+ */
+class RecordingVideoProvider : public VideoProvider {
+ public:
+  explicit RecordingVideoProvider(const std::string &filename);
+
+  inline std::string Id() const {
+    return filename_;
+  }
+
+  FrameIterator begin() override;
+
+  FrameIterator end() override;
+
+  /** Whether the file looks like a stream file */
+  static bool IsRecording(const std::string &filename);
+
+ private:
+  const std::string filename_;
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_RECORDING_VIDEO_PROVIDER_H_
@@ -28,6 +28,18 @@ class SearchingTracker : public InnerTracker {
 
   bool Track(const Frame &frame, Posit *result) override;
 
+  bool Track(const Frame &frame,
+             const Point2 expected,
+             const Point2 deviation,
+             Posit *result) override;
+
+  bool Predict(const Frame &frame, Posit *result) override;
+
+  void Observe(const Frame &frame, const Posit posit) override;
+
+  /** Extent of tracker data (as searched) */
+  bool ObjectSize(Point2 *size) const override;
+
   // FIXME override other ReinitializeTracking overloads
   bool ReinitializeTracking(const Frame &frame, Posit *result) override;
 
@@ -70,6 +82,13 @@ class SearchingTracker : public InnerTracker {
       const double threshold,
       Mark *result) const = 0;
 
+  /** Learn from successfully tracked object (optional)
+   *
+   * Called after match of own tracker data, not after (re)initializations.
+   */
+  virtual void UpdateTrackerData(const cv::Mat &data, const Mark &match) {
+  }
+
   virtual Posit MarkToPosit(const Mark &mark) const = 0;
 
   virtual cv::Rect DataToRoi(const TrackerData &tracker_data, const Point2 exp,
@@ -84,6 +103,11 @@ class SearchingTracker : public InnerTracker {
   }
 
   void InitializeKalmanFilter();
+
+  bool SearchAround(const Frame &frame,
+                    const Point2 expected,
+                    const Point2 deviation,
+                    Posit *result);
 };
 
 } // namespace dove_eye
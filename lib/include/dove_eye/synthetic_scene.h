@@ -0,0 +1,173 @@
+#ifndef DOVE_EYE_SYNTHETIC_SCENE_H_
+#define DOVE_EYE_SYNTHETIC_SCENE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "dove_eye/calibration_data.h"
+#include "dove_eye/frame.h"
+#include "dove_eye/location.h"
+#include "dove_eye/positset.h"
+#include "dove_eye/types.h"
+
+namespace dove_eye {
+
+/** Scripted scene with single object seen by calibrated cameras
+ *
+ * Scene is deterministic, any frame (incl. noise) depends only on the
+ * settings, camera and frame number, thus it can be rendered in any order
+ * and ground truth is known exactly.
+ *
+ * Frame n of any camera has timestamp (n + 1) / fps (same as FpsPolicy).
+ */
+class SyntheticScene {
+ public:
+  enum ObjectType {
+    /** Shaded ball of the color */
+    kBall,
+    /** Square checkerboard patch (facing camera) */
+    kPatch
+  };
+
+  struct Waypoint {
+    Frame::Timestamp time;
+    Location location;
+  };
+
+  typedef std::vector<Waypoint> Trajectory;
+
+  /** Object is not drawn into cam during [begin, end) */
+  struct Occlusion {
+    CameraIndex cam;
+    Frame::Timestamp begin;
+    Frame::Timestamp end;
+  };
+
+  typedef std::vector<Occlusion> OcclusionVector;
+
+  struct Settings {
+    int width;
+    int height;
+    double fps;
+
+    ObjectType object_type;
+    /** Radius of ball or half side of patch (m) */
+    double object_size;
+    /** BGR */
+    cv::Scalar object_color;
+
+    /** Standard deviation of additive pixel noise */
+    double noise;
+    uint64_t seed;
+
+    Settings()
+        : width(640),
+          height(480),
+          fps(30),
+          object_type(kBall),
+          object_size(0.03),
+          object_color(0, 0, 255),
+          noise(2),
+          seed(0) {
+    }
+  };
+
+  /**
+   * \param trajectory   waypoints ordered by time (linearly interpolated),
+   *                     the last one determines duration of the scene
+   */
+  SyntheticScene(const CalibrationData &calibration_data,
+                 const Trajectory &trajectory,
+                 const Settings &settings = Settings(),
+                 const OcclusionVector &occlusions = OcclusionVector());
+
+  /** Rig of cameras on an arc around a point, all looking at it
+   *
+   * Camera 0 is the origin of the world (looking along z), the point is
+   * distance meters in front of it, other cameras are rotated around the
+   * point (about y axis) by angle (rad) each. Cameras have no distortion.
+   *
+   * \param fov   horizontal field of view (rad)
+   */
+  static CalibrationData CreateRig(const CameraIndex arity,
+                                   const int width, const int height,
+                                   const double fov = 1.0,
+                                   const double distance = 2.0,
+                                   const double angle = 0.5);
+
+  inline CameraIndex Arity() const {
+    return calibration_data_.Arity();
+  }
+
+  inline const CalibrationData &calibration_data() const {
+    return calibration_data_;
+  }
+
+  inline const Settings &settings() const {
+    return settings_;
+  }
+
+  inline size_t FrameCount() const {
+    return frame_count_;
+  }
+
+  inline Frame::Timestamp FrameTimestamp(const size_t frame_no) const {
+    return (frame_no + 1) / settings_.fps;
+  }
+
+  /** Ground truth location of the object */
+  Location LocationAt(const Frame::Timestamp time) const;
+
+  /** Ground truth posit of the object
+   *
+   * @return  false when object is occluded or out of the image (posit is
+   *          set anyway)
+   */
+  bool PositAt(const CameraIndex cam, const Frame::Timestamp time,
+               Posit *result) const;
+
+  /** Ground truth posit and apparent size of the object
+   *
+   * \param radius  radius of ball or half side of patch (px)
+   */
+  bool PositAt(const CameraIndex cam, const Frame::Timestamp time,
+               Posit *result, double *radius) const;
+
+  /** Ground truth of all cameras */
+  Positset PositsetAt(const Frame::Timestamp time) const;
+
+  /**
+   * \param background  background of the camera from Background()
+   * \param result      reallocated only when it has different size or type
+   * \param noise       scratch buffer for noise, same reuse as result
+   */
+  void Render(const CameraIndex cam, const size_t frame_no,
+              const cv::Mat &background, cv::Mat *result,
+              cv::Mat *noise) const;
+
+  /** Smooth random texture (so that object surroundings aren't uniform) */
+  cv::Mat Background(const CameraIndex cam) const;
+
+ private:
+  const CalibrationData calibration_data_;
+  const Trajectory trajectory_;
+  const Settings settings_;
+  const OcclusionVector occlusions_;
+
+  size_t frame_count_;
+
+  /**
+   * \param radius  apparent size of the object (px)
+   * \return        false when object is behind the camera
+   */
+  bool Project(const CameraIndex cam, const Location location,
+               Posit *posit, double *radius) const;
+
+  bool IsOccluded(const CameraIndex cam, const Frame::Timestamp time) const;
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_SYNTHETIC_SCENE_H_
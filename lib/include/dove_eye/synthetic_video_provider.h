@@ -0,0 +1,48 @@
+#ifndef DOVE_EYE_SYNTHETIC_VIDEO_PROVIDER_H_
+#define DOVE_EYE_SYNTHETIC_VIDEO_PROVIDER_H_
+
+#include <memory>
+#include <string>
+
+#include "dove_eye/synthetic_scene.h"
+#include "dove_eye/video_provider.h"
+
+namespace dove_eye {
+
+/** Renders frames of a single camera of SyntheticScene
+ *
+ * Frames are rendered on demand (as fast as consumed) into pooled buffers,
+ * ground truth is available from the scene.
+ */
+class SyntheticVideoProvider : public VideoProvider {
+ public:
+  typedef std::shared_ptr<const SyntheticScene> ScenePtr;
+
+  SyntheticVideoProvider(const ScenePtr scene, const CameraIndex cam);
+
+  inline std::string Id() const {
+    return "synthetic:" + std::to_string(cam_);
+  }
+
+  FrameIterator begin() override;
+
+  FrameIterator end() override;
+
+  inline bool Seekable() const override {
+    return true;
+  }
+
+  FrameIterator Seek(const Frame::Timestamp timestamp) override;
+
+  inline const SyntheticScene &scene() const {
+    return *scene_;
+  }
+
+ private:
+  const ScenePtr scene_;
+  const CameraIndex cam_;
+};
+
+} // namespace dove_eye
+
+#endif // DOVE_EYE_SYNTHETIC_VIDEO_PROVIDER_H_
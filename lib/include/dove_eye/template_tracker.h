@@ -1,18 +1,42 @@
 #ifndef DOVE_EYE_TEMPLATE_TRACKER_H_
 #define DOVE_EYE_TEMPLATE_TRACKER_H_
 
+#include <vector>
+
 #include <opencv2/opencv.hpp>
 
 #include "dove_eye/searching_tracker.h"
 
 namespace dove_eye {
 
+/** Tracks object by matching a small appearance model
+ *
+ * The model is the initial template (never replaced, it prevents drift) and
+ * a ring of recent templates, a template is added only after confident match
+ * (peak correlation above TEMPLATE_UPDATE) of the model. The best matching
+ * template is promoted and tried first next time, when it's confident enough
+ * the others are skipped.
+ */
 class TemplateTracker : public SearchingTracker {
  public:
   struct TemplateData : public TrackerData {
-    cv::Mat search_template;
+    /** Initial template followed by ring of recent ones, all same size */
+    std::vector<cv::Mat> templates;
+    /** Slot of the ring to be overwritten next */
+    size_t next;
+    /** Template of the last match (promoted) and its correlation */
+    size_t best;
+    double best_value;
+
     double radius;
 
+    TemplateData()
+        : next(1),
+          best(0),
+          best_value(0),
+          radius(0) {
+    }
+
     /**
      * @param   point   position of template object
      * @return          top-left corner of the template
@@ -63,6 +87,8 @@ class TemplateTracker : public SearchingTracker {
       const double threshold,
       Mark *result) const override;
 
+  void UpdateTrackerData(const cv::Mat &data, const Mark &match) override;
+
   inline Posit MarkToPosit(const Mark &mark) const override {
     assert(mark.type == Mark::kCircle);
     return mark.center;
@@ -78,6 +104,14 @@ class TemplateTracker : public SearchingTracker {
 
  private:
   TemplateData data_;
+
+  /** Match single template, mask is already shifted to the result
+   * @param[out]  correlation   normalized correlation at the match (at most 1)
+   * @return  value of the match
+   */
+  double MatchTemplate(const cv::Mat &data, const cv::Mat &search_template,
+                       const cv::Mat *shifted_mask, cv::Mat *match_result,
+                       cv::Point *loc, double *correlation) const;
 };
 
 } // namespace dove_eye
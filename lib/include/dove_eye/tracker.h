@@ -1,34 +1,90 @@
 #ifndef DOVE_EYE_TRACKER_H_
 #define DOVE_EYE_TRACKER_H_
 
+#include <chrono>
 #include <memory>
 #include <vector>
 
 #include <opencv2/opencv.hpp>
 
 #include "dove_eye/calibration_data.h"
+#include "dove_eye/constant_velocity_kalman.h"
 #include "dove_eye/frame.h"
 #include "dove_eye/frameset.h"
 #include "dove_eye/inner_tracker.h"
+#include "dove_eye/localization.h"
 #include "dove_eye/location.h"
+#include "dove_eye/metrics.h"
+#include "dove_eye/parameters.h"
 #include "dove_eye/positset.h"
 
 namespace dove_eye {
 
 /**
+ * In fused mode, tracker keeps a single 3D Kalman state of the object. It's
+ * predicted once per frameset and projected into every camera to seed
+ * search of inner trackers, triangulated posits then correct the 3D state.
+ * Fused mode requires calibration data.
+ *
+ * Each camera's tracking may be decimated: while the object is (nearly)
+ * static and predictable, frames are skipped (inner tracker only advances
+ * its prediction) up to DECIMATION_MAX, any motion returns to full rate.
+ * Independently, TRACK_BUDGET limits tracking time per second of each
+ * camera, the remaining frames are skipped too.
+ *
+ * Tracker counts losses, re-acquisitions and time spent per camera, so that
+ * inner trackers and parameters can be compared (see statistics()). Tracker
+ * states and the same events are exported to Metrics too.
+ *
  * @note This class is not (intentionaly) thread safe, i.e. can be used in
  *       single thread only.
  */
 class Tracker {
  public:
-  explicit Tracker(const CameraIndex arity, const InnerTracker &inner_tracker);
+  typedef std::chrono::steady_clock Clock;
+
+  /** Counters of tracking events per camera */
+  struct Statistics {
+    /** Frames after initialization */
+    size_t frames;
+    /** Frames with a valid posit (including predicted ones) */
+    size_t tracked;
+    /** Frames left out by decimation or budget */
+    size_t skipped;
+    size_t losses;
+
+    /* Re-acquisitions by their source */
+    size_t found_projection;
+    size_t found_epiline;
+    size_t found_global;
+
+    /** Time spent in the inner tracker */
+    Clock::duration time;
+
+    Statistics()
+        : frames(0),
+          tracked(0),
+          skipped(0),
+          losses(0),
+          found_projection(0),
+          found_epiline(0),
+          found_global(0),
+          time(Clock::duration::zero()) {
+    }
+  };
+
+  Tracker(const Parameters &parameters, const CameraIndex arity,
+          const InnerTracker &inner_tracker);
 
-  Positset SetMark(const Frameset &frameset, const CameraIndex cam,
-               const InnerTracker::Mark mark, bool project_other = false);
+  /** Returned reference is valid until the next SetMark()/Track() call */
+  const Positset &SetMark(const Frameset &frameset, const CameraIndex cam,
+                          const InnerTracker::Mark mark,
+                          bool project_other = false);
 
+  /** Location (e.g. from localization) used for reinitialization */
   bool SetLocation(const Location location);
 
-  Positset Track(const Frameset &frameset);
+  const Positset &Track(const Frameset &frameset);
 
   inline bool distorted_input() const {
     return distorted_input_;
@@ -48,8 +104,21 @@ class Tracker {
 
   inline void calibration_data(const CalibrationData *value) {
     calibration_data_ = value;
+    localization_.calibration_data(value);
+  }
+
+  inline bool fused() const {
+    return fused_;
+  }
+
+  void fused(const bool value);
+
+  inline const Statistics &statistics(const CameraIndex cam) const {
+    return statistics_[cam];
   }
 
+  void ResetStatistics();
+
  private:
   enum TrackState {
     kUninitialized,
@@ -60,6 +129,49 @@ class Tracker {
   typedef std::vector<TrackState> StateVector;
   typedef std::unique_ptr<InnerTracker> InnerTrackerPtr;
   typedef std::vector<InnerTrackerPtr> TrackerVector;
+  typedef ConstantVelocityKalman<3> LocationFilter;
+  typedef std::vector<Statistics> StatisticsVector;
+
+  /** Registered metrics of a camera */
+  struct CameraMetrics {
+    Gauge *state;
+    Gauge *state_time;
+    Counter *losses;
+    Counter *found_projection;
+    Counter *found_epiline;
+    Counter *found_global;
+
+    /** When current state was entered */
+    Clock::time_point since;
+  };
+
+  typedef std::vector<CameraMetrics> MetricsVector;
+
+  struct Decimation {
+    /** Every stride-th frame is tracked */
+    int stride;
+    int skipped;
+
+    bool has_last;
+    Posit last;
+    /** Per frame */
+    Point2 velocity;
+
+    /** Tracking time spent in the current (1 s) window */
+    Clock::time_point window_start;
+    Clock::duration busy;
+
+    Decimation()
+        : stride(1),
+          skipped(0),
+          has_last(false),
+          busy(Clock::duration::zero()) {
+    }
+  };
+
+  typedef std::vector<Decimation> DecimationVector;
+
+  const Parameters &parameters_;
 
   const CameraIndex arity_;
 
@@ -69,6 +181,9 @@ class Tracker {
   StateVector trackstates_;
 
   TrackerVector trackers_;
+  DecimationVector decimations_;
+  StatisticsVector statistics_;
+  MetricsVector metrics_;
 
   bool distorted_input_;
 
@@ -77,7 +192,28 @@ class Tracker {
   Location location_;
   bool location_valid_;
 
-  bool TrackSingle(const CameraIndex cam, const Frame &frame);
+  bool fused_;
+  Localization localization_;
+  LocationFilter location_filter_;
+
+  /**
+   * \param expected   (optional) expected posit, deviation must be given too
+   */
+  bool TrackSingle(const CameraIndex cam, const Frame &frame,
+                   const Point2 *expected = nullptr,
+                   const Point2 *deviation = nullptr);
+
+  void TrackFused(const Frameset &frameset);
+
+  void SetState(const CameraIndex cam, const TrackState state);
+
+  /** Whether tracking of the frame should be skipped, counts skipped frames */
+  bool SkipFrame(const CameraIndex cam);
+
+  /** Adapt stride to the motion of tracked posit */
+  void UpdateDecimation(const CameraIndex cam, const Posit &posit);
+
+  void ResetDecimation(const CameraIndex cam);
 
   Point2 Undistort(const Point2 &point, const CameraIndex cam) const;
 
@@ -87,6 +223,9 @@ class Tracker {
       const CameraIndex cam) const;
 
   Point2 ReprojectLocation(const Location location, const CameraIndex cam) const;
+
+  Point2Vector ReprojectLocations(const Point3Vector &object_points,
+                                  const CameraIndex cam) const;
 };
 
 } // namespace dove_eye
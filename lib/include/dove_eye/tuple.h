@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <utility>
 
 #include "config.h"
 #include "dove_eye/types.h"
@@ -28,7 +29,7 @@ class Tuple {
 
   /*
    * Because of the const member arity_ we have to provide the Big Five
-   * methods for copying/moving.
+   * methods for copying/moving. They touch only first arity_ items.
    */
   explicit Tuple(const CameraIndex size = 0, const size_t sequence_no = 0)
       : sequence_no(sequence_no),
@@ -60,21 +61,41 @@ class Tuple {
   }
 
   inline Tuple &operator=(const Tuple &rhs) {
-    Tuple tmp(rhs);
-    *this = std::move(tmp);
+    assert(arity_ == rhs.arity_);
+
+    sequence_no = rhs.sequence_no;
+    for (CameraIndex cam = 0; cam < arity_; ++cam) {
+      items_[cam] = rhs.items_[cam];
+      validity_[cam] = rhs.validity_[cam];
+    }
+
     return *this;
   }
 
   inline Tuple &operator=(Tuple &&rhs) {
     assert(arity_ == rhs.arity_);
 
-    std::swap(sequence_no, rhs.sequence_no);
-    std::swap(items_, rhs.items_);
-    std::swap(validity_, rhs.validity_);
+    sequence_no = rhs.sequence_no;
+    for (CameraIndex cam = 0; cam < arity_; ++cam) {
+      items_[cam] = std::move(rhs.items_[cam]);
+      validity_[cam] = rhs.validity_[cam];
+    }
 
     return *this;
   }
 
+  /** Replace item of the camera with one built from args and mark it valid
+   *
+   * Items are stored in a plain array, thus the new item is move-assigned.
+   */
+  template<typename... Args>
+  inline T &Emplace(const CameraIndex cam, Args &&... args) {
+    assert(cam < arity_);
+    items_[cam] = T(std::forward<Args>(args)...);
+    validity_[cam] = true;
+    return items_[cam];
+  }
+
   inline T &operator[](const CameraIndex cam) {
     assert(cam < arity_);
     return items_[cam];
@@ -26,6 +26,20 @@ class VideoProvider {
   virtual FrameIterator begin() = 0;
   virtual FrameIterator end() = 0;
 
+  /** Whether provider supports random access */
+  virtual bool Seekable() const {
+    return false;
+  }
+
+  /** Iterator to the first frame not earlier than timestamp
+   *
+   * Timestamps are in the same scale as those of frames from begin().
+   * Providers that aren't seekable return end().
+   */
+  virtual FrameIterator Seek(const Frame::Timestamp timestamp) {
+    return end();
+  }
+
   inline bool undistort() const {
     return undistort_;
   }
@@ -1,5 +1,10 @@
 #include "dove_eye/aggregator_iterator.h"
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <utility>
+
 #include "dove_eye/aggregator.h"
 
 namespace dove_eye {
@@ -31,26 +36,30 @@ AggregatorIterator &AggregatorIterator::operator++() {
   bool frameset_created = false;
 
   do {
+    /* Single consistent view of offsets and window per frame */
+    const auto &params = aggregator_->parameters().snapshot();
+
     if (valid_ && !aggregator_->GetFrame(&frame, &cam)) {
       valid_ = false;
       return *this;
     }
+    aggregator_->frames_metrics_[cam]->Add();
 
     /*
      * Apply offset,
      * see http://www.ms.mff.cuni.cz/~koutnym/wiki/dove_eye/calibration/time
      */
-    frame.timestamp -=
-        aggregator_->parameters().Get(Parameters::CAM_OFFSET, cam);
+    frame.timestamp -= params.Get(Parameters::CAM_OFFSET, cam);
+    const auto timestamp = frame.timestamp;
 
-    queues_[cam].push_back(frame);
+    /* Frame is assigned anew by GetFrame, its buffer can be moved */
+    queues_[cam].push_back(std::move(frame));
 
-    auto window_size =
-        aggregator_->parameters().Get(Parameters::AGGREGATOR_WINDOW);
+    auto window_size = params.Get(Parameters::AGGREGATOR_WINDOW);
 
     /* Move the window forwards? */
-    if (frame.timestamp > window_start_ + window_size) {
-      window_start_ = frame.timestamp - window_size;
+    if (timestamp > window_start_ + window_size) {
+      window_start_ = timestamp - window_size;
       frameset_created = PrepareFrameset();
       frameset_.sequence_no += 1;
     }
@@ -59,6 +68,31 @@ AggregatorIterator &AggregatorIterator::operator++() {
   return *this;
 }
 
+bool AggregatorIterator::Seek(const Frame::Timestamp timestamp) {
+  assert(aggregator_);
+
+  /* Inverse of offset application in operator++ */
+  Aggregator::TimestampsContainer timestamps(aggregator_->Arity());
+  for (CameraIndex cam = 0; cam < aggregator_->Arity(); ++cam) {
+    timestamps[cam] = timestamp +
+        aggregator_->parameters().Get(Parameters::CAM_OFFSET, cam);
+  }
+
+  if (!aggregator_->Seek(timestamps)) {
+    return false;
+  }
+
+  for (auto &queue : queues_) {
+    queue.clear();
+  }
+  window_start_ = timestamp -
+      aggregator_->parameters().Get(Parameters::AGGREGATOR_WINDOW);
+  valid_ = true;
+
+  operator++();
+  return true;
+}
+
 bool AggregatorIterator::PrepareFrameset() {
   bool frameset_created = false;
   for (CameraIndex cam = 0; cam < aggregator_->Arity(); ++cam) {
@@ -66,20 +100,31 @@ bool AggregatorIterator::PrepareFrameset() {
     bool has_frame = false;
     while (!queues_[cam].empty() &&
            queues_[cam].front().timestamp < window_start_) {
-      last_frame = queues_[cam].front();
+      last_frame = std::move(queues_[cam].front());
       has_frame = true;
       queues_[cam].pop_front();
     }
 
     if (has_frame) {
-      frameset_.SetValid(cam);
-      frameset_[cam] = last_frame;
+      frameset_.Emplace(cam, std::move(last_frame));
       frameset_created = true;
     } else {
       frameset_.SetValid(cam, false);
     }
   }
 
+  if (frameset_created) {
+    Frame::Timestamp min_timestamp = std::numeric_limits<double>::max();
+    Frame::Timestamp max_timestamp = std::numeric_limits<double>::lowest();
+    for (CameraIndex cam = 0; cam < aggregator_->Arity(); ++cam) {
+      if (frameset_.IsValid(cam)) {
+        min_timestamp = std::min(min_timestamp, frameset_[cam].timestamp);
+        max_timestamp = std::max(max_timestamp, frameset_[cam].timestamp);
+      }
+    }
+    aggregator_->skew_metric_.Set(max_timestamp - min_timestamp);
+  }
+
   return frameset_created;
 }
 
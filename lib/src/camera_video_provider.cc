@@ -30,6 +30,11 @@ FrameIterator CameraVideoProvider::begin() {
     capture.set(CV_CAP_PROP_FRAME_HEIGHT, resolution().height);
   }
 
+  /* First frame in the requested resolution */
+  if (cv_iterator->IsValid()) {
+    cv_iterator->MoveNext();
+  }
+
   return FrameIterator(this, cv_iterator);
 }
 
@@ -1,6 +1,8 @@
 #include "dove_eye/circle_tracker.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 #include <opencv2/opencv.hpp>
 
@@ -8,12 +10,97 @@
 #include "dove_eye/cv_logging.h"
 #include "dove_eye/logging.h"
 
+using cv::GaussianBlur;
 using cv::HoughCircles;
 using cv::cvtColor;
 using cv::mixChannels;
 using cv::Scalar;
 using std::vector;
 
+namespace {
+
+/** Circle fitting to the object edge in predicted ROI */
+const size_t kFitMinPoints = 12;
+/** Largest distance of an inlier edge point from the circle */
+const double kFitInlierDistance = 1.5;
+/** Smallest inlier fraction of circumference for a fitted circle */
+const double kFitMinSupport = 0.5;
+/** Inlier fraction of circumference that stops the sampling early */
+const double kFitGoodSupport = 0.75;
+/** Upper bound on sampled circles */
+const int kFitIterations = 100;
+/** Fixed seed, the fit must be reproducible in replays */
+const uint64 kFitSeed = 0x5eed;
+/** Denoise kernel before fitting (relative to radius) */
+const double kFitBlurFactor = 0.5;
+
+/** Odd kernel size not smaller than size */
+cv::Size KernelSize(const double size) {
+  int result = std::max(1, cvRound(size));
+  result += 1 - (result % 2);
+  return cv::Size(result, result);
+}
+
+/** Least squares fit of x^2 + y^2 + Dx + Ey + F = 0 (Kasa) */
+bool AlgebraicFit(const vector<cv::Point> &points, cv::Vec3f *circle) {
+  cv::Mat lhs(points.size(), 3, CV_64F);
+  cv::Mat rhs(points.size(), 1, CV_64F);
+  for (size_t i = 0; i < points.size(); ++i) {
+    lhs.at<double>(i, 0) = points[i].x;
+    lhs.at<double>(i, 1) = points[i].y;
+    lhs.at<double>(i, 2) = 1;
+    rhs.at<double>(i, 0) = -(points[i].x * points[i].x +
+                             points[i].y * points[i].y);
+  }
+
+  cv::Mat solution;
+  if (!cv::solve(lhs, rhs, solution, cv::DECOMP_SVD)) {
+    return false;
+  }
+
+  const double x = -0.5 * solution.at<double>(0);
+  const double y = -0.5 * solution.at<double>(1);
+  const double r2 = x * x + y * y - solution.at<double>(2);
+  if (r2 <= 0) {
+    return false;
+  }
+
+  *circle = cv::Vec3f(x, y, std::sqrt(r2));
+  return true;
+}
+
+/** Circle through three points */
+bool CircumscribedCircle(const cv::Point &a, const cv::Point &b,
+                         const cv::Point &c, cv::Vec3f *circle) {
+  const double d = 2.0 * (a.x * (b.y - c.y) + b.x * (c.y - a.y) +
+                          c.x * (a.y - b.y));
+  if (std::abs(d) < 1e-9) {
+    return false;
+  }
+
+  const double a2 = a.x * a.x + a.y * a.y;
+  const double b2 = b.x * b.x + b.y * b.y;
+  const double c2 = c.x * c.x + c.y * c.y;
+  const double x = (a2 * (b.y - c.y) + b2 * (c.y - a.y) + c2 * (a.y - b.y)) / d;
+  const double y = (a2 * (c.x - b.x) + b2 * (a.x - c.x) + c2 * (b.x - a.x)) / d;
+
+  *circle = cv::Vec3f(x, y, std::hypot(a.x - x, a.y - y));
+  return true;
+}
+
+/** Number of points closer than kFitInlierDistance to the circle */
+size_t CountInliers(const vector<cv::Point> &points, const cv::Vec3f &circle) {
+  size_t result = 0;
+  for (auto &point : points) {
+    const double distance = std::hypot(point.x - circle[0],
+                                       point.y - circle[1]) - circle[2];
+    result += (std::abs(distance) < kFitInlierDistance);
+  }
+  return result;
+}
+
+} // anonymous namespace
+
 namespace dove_eye {
 
 bool CircleTracker::InitTrackerData(const cv::Mat &data, const Mark &mark) {
@@ -21,7 +108,12 @@ bool CircleTracker::InitTrackerData(const cv::Mat &data, const Mark &mark) {
   return UpdateData(data_, data, mark);
 }
 
-/** Use Hough transform to find best matching circle
+/** Find best matching circle
+ *
+ * Circle around the predicted position (ROI smaller than the frame given) is
+ * fitted to the object edge, Hough transform is used for global search only.
+ * A failed fit isn't retried with Hough in the ROI, the object is lost and
+ * found by the global search (reinitialization).
  *
  * @see SearchingTracker::Search()
  */
@@ -47,17 +139,32 @@ bool CircleTracker::Search(
 
   auto data_roi = data(extended_roi);
   log_mat(reinterpret_cast<size_t>(this) * 100 + 1, data_roi);
-  auto data_proc = PreprocessImage(data_roi, circle_data, threshold);
-  log_mat(reinterpret_cast<size_t>(this) * 100 + 2, data_proc);
+  const auto backproj = PreprocessImage(data_roi, circle_data, threshold);
 
   CircleVector circles;
-  HoughCircles(data_proc, circles, CV_HOUGH_GRADIENT,
-               2, // accumulator ratio (to original image resolution)
-               data_proc.rows / 2, //minDist between centers of circles
-               10, //param1 (Canny threshold)
-               25, //param2 (accumulator threshold)
-               circle_data.radius / radius_factor, //minRadius
-               circle_data.radius * radius_factor); // maxRadius
+  cv::Mat data_proc;
+  if (extended_roi.size() != data.size()) {
+    /* Edge needs only light denoising, kernel follows the object */
+    GaussianBlur(backproj, data_proc,
+                 KernelSize(kFitBlurFactor * circle_data.radius), 0);
+    Circle fitted;
+    if (FitCircle(data_proc, circle_data.radius / radius_factor,
+                  circle_data.radius * radius_factor, &fitted)) {
+      circles.push_back(fitted);
+    }
+  } else {
+    /* Denoise */
+    GaussianBlur(backproj, data_proc,
+                 KernelSize(parameters().Get(Parameters::TEMPLATE_RADIUS)), 0);
+    HoughCircles(data_proc, circles, CV_HOUGH_GRADIENT,
+                 2, // accumulator ratio (to original image resolution)
+                 data_proc.rows / 2, //minDist between centers of circles
+                 10, //param1 (Canny threshold)
+                 25, //param2 (accumulator threshold)
+                 circle_data.radius / radius_factor, //minRadius
+                 circle_data.radius * radius_factor); // maxRadius
+  }
+  log_mat(reinterpret_cast<size_t>(this) * 100 + 2, data_proc);
 
 
   /* (Motion) mask is ignored. */
@@ -132,7 +239,7 @@ bool CircleTracker::UpdateData(CircleData &circle_data, const cv::Mat &data,
  * @param[in]   circle_data
  * @param[in]   threshold HSV threshoold
  *
- * @return  grayscale image with circles to search
+ * @return  backprojection (not denoised) with circles to search
  */
 cv::Mat CircleTracker::PreprocessImage(const cv::Mat &data,
                                        const CircleData &circle_data,
@@ -143,13 +250,6 @@ cv::Mat CircleTracker::PreprocessImage(const cv::Mat &data,
   cv::Mat hsv_components[3];
   cv::split(hsv, hsv_components);
 
-  /* Prepare denoise kernel */
-  auto radius = parameters().Get(Parameters::TEMPLATE_RADIUS);
-  cv::Size blur_size(radius, radius);
-
-  blur_size.width += 1 - (blur_size.width % 2);
-  blur_size.height += 1 - (blur_size.height % 2);
-
   /* Caclulate backprojection */
   const float *prange = circle_data.hrange;
   cv::Mat backproj;
@@ -168,12 +268,85 @@ cv::Mat CircleTracker::PreprocessImage(const cv::Mat &data,
                circle_data.vrange[1]),
         mask);
   backproj &= mask;
-
-  /* Denoise */
-  cv::GaussianBlur(backproj, backproj, blur_size, 0);
   return backproj;
 }
 
+/** Circle fitted to edge points of the image (RANSAC)
+ *
+ * Circles through three random edge points are scored by the number of edge
+ * points near them, sampling stops as soon as a circle is supported by most
+ * of its circumference. The best circle is refined algebraically from its
+ * inliers. Clutter edges only dilute the inliers, they don't bias the fit.
+ *
+ * @return  false when no circle of given radius range has enough support
+ */
+bool CircleTracker::FitCircle(const cv::Mat &data_proc,
+                              const double min_radius,
+                              const double max_radius,
+                              Circle *result) const {
+  cv::Mat edges;
+  cv::Canny(data_proc, edges,
+            5, // low threshold (as Hough's param1 / 2)
+            10); // high threshold (as Hough's param1)
+
+  vector<cv::Point> points;
+  cv::findNonZero(edges, points);
+  if (points.size() < kFitMinPoints) {
+    DEBUG("%s few-edges (%zu)", __func__, points.size());
+    return false;
+  }
+
+  cv::RNG rng(kFitSeed);
+  const int count = points.size();
+  double best_support = kFitMinSupport;
+  Circle best;
+  bool found = false;
+  for (int i = 0; i < kFitIterations && best_support < kFitGoodSupport; ++i) {
+    const auto &a = points[rng.uniform(0, count)];
+    const auto &b = points[rng.uniform(0, count)];
+    const auto &c = points[rng.uniform(0, count)];
+
+    Circle circle;
+    if (!CircumscribedCircle(a, b, c, &circle) ||
+        circle[2] < min_radius || circle[2] > max_radius) {
+      continue;
+    }
+
+    const double support = CountInliers(points, circle) /
+        (2 * CV_PI * circle[2]);
+    if (support > best_support) {
+      best_support = support;
+      best = circle;
+      found = true;
+    }
+  }
+
+  if (!found) {
+    DEBUG("%s no-supported-circle (%zu edges)", __func__, points.size());
+    return false;
+  }
+
+  /* Refine from inliers, keep the sample when refinement leaves the range */
+  vector<cv::Point> inliers;
+  for (auto &point : points) {
+    const double distance = std::hypot(point.x - best[0],
+                                       point.y - best[1]) - best[2];
+    if (std::abs(distance) < kFitInlierDistance) {
+      inliers.push_back(point);
+    }
+  }
+
+  Circle refined;
+  if (AlgebraicFit(inliers, &refined) &&
+      refined[2] >= min_radius && refined[2] <= max_radius) {
+    best = refined;
+  }
+
+  DEBUG("%s support: %f", __func__, best_support);
+  *result = best;
+  return true;
+}
+
 /**
  * @return Match score [0, 1] of the best circle (0 for none)
  */
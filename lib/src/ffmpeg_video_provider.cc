@@ -0,0 +1,284 @@
+#include "dove_eye/ffmpeg_video_provider.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+#include "dove_eye/frame_iterator.h"
+#include "dove_eye/logging.h"
+
+namespace {
+
+/** Whether anybody else than the pool refers to the buffer
+ *
+ * Consumers release their references in other threads, counter is read
+ * atomically (as cv::Mat changes it).
+ */
+inline bool IsShared(const cv::Mat &mat) {
+#if CV_MAJOR_VERSION < 3
+  return mat.refcount && CV_XADD(mat.refcount, 0) > 1;
+#else
+  return mat.u && CV_XADD(&mat.u->refcount, 0) > 1;
+#endif
+}
+
+} // anonymous namespace
+
+namespace dove_eye {
+
+/**
+ * Constructor only opens the file, the first frame is decoded with MoveNext()
+ * or Seek() before the iterator is handed over to FrameIterator.
+ */
+class FfmpegFrameIterator : public FrameIteratorImpl {
+ public:
+  explicit FfmpegFrameIterator(const std::string &filename)
+      : format_(nullptr),
+        codec_(nullptr),
+        packet_(nullptr),
+        av_frame_(nullptr),
+        sws_(nullptr),
+        stream_index_(-1),
+        start_pts_(0),
+        draining_(false) {
+    frame_.timestamp = 0;
+    valid_ = Open(filename);
+    if (!valid_) {
+      ERROR("Cannot open '%s' for decoding", filename.c_str());
+    }
+  }
+
+  ~FfmpegFrameIterator() override {
+    sws_freeContext(sws_);
+    av_frame_free(&av_frame_);
+    av_packet_free(&packet_);
+    avcodec_free_context(&codec_);
+    avformat_close_input(&format_);
+  }
+
+  /**
+   * Frame data are in pooled buffer that is not reused while referenced, so
+   * no copy is needed.
+   */
+  inline Frame GetFrame() const override {
+    return frame_;
+  }
+
+  inline void MoveNext() override {
+    valid_ = DecodeNext();
+    if (valid_) {
+      Convert();
+    }
+  }
+
+  inline bool IsValid() override {
+    return valid_;
+  }
+
+  /** Move to the first frame not earlier than timestamp
+   *
+   * Demuxer jumps to the preceding keyframe, frames in between are decoded
+   * but not converted.
+   */
+  bool Seek(const Frame::Timestamp timestamp) {
+    auto target = start_pts_ +
+        static_cast<int64_t>(timestamp / av_q2d(time_base_));
+    if (av_seek_frame(format_, stream_index_, target,
+                      AVSEEK_FLAG_BACKWARD) < 0) {
+      return false;
+    }
+    avcodec_flush_buffers(codec_);
+    draining_ = false;
+
+    while ((valid_ = DecodeNext())) {
+      if (FrameTimestamp() >= timestamp - kTimestampTolerance) {
+        Convert();
+        break;
+      }
+    }
+    return true;
+  }
+
+ private:
+  static const size_t kMaxPoolSize = 32;
+  static constexpr double kTimestampTolerance = 1e-6;
+
+  AVFormatContext *format_;
+  AVCodecContext *codec_;
+  AVPacket *packet_;
+  AVFrame *av_frame_;
+  SwsContext *sws_;
+
+  int stream_index_;
+  AVRational time_base_;
+  int64_t start_pts_;
+
+  bool valid_;
+  bool draining_;
+  Frame frame_;
+
+  std::vector<cv::Mat> pool_;
+
+  bool Open(const std::string &filename) {
+    if (avformat_open_input(&format_, filename.c_str(), nullptr, nullptr) < 0) {
+      return false;
+    }
+    if (avformat_find_stream_info(format_, nullptr) < 0) {
+      return false;
+    }
+
+    stream_index_ = av_find_best_stream(format_, AVMEDIA_TYPE_VIDEO, -1, -1,
+                                        nullptr, 0);
+    if (stream_index_ < 0) {
+      return false;
+    }
+
+    auto stream = format_->streams[stream_index_];
+    auto decoder = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (!decoder) {
+      return false;
+    }
+
+    codec_ = avcodec_alloc_context3(decoder);
+    if (!codec_ ||
+        avcodec_parameters_to_context(codec_, stream->codecpar) < 0) {
+      return false;
+    }
+
+    /* Zero means as many threads as there are cores */
+    codec_->thread_count = 0;
+    codec_->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    if (avcodec_open2(codec_, decoder, nullptr) < 0) {
+      return false;
+    }
+
+    time_base_ = stream->time_base;
+    if (stream->start_time != AV_NOPTS_VALUE) {
+      start_pts_ = stream->start_time;
+    }
+
+    packet_ = av_packet_alloc();
+    av_frame_ = av_frame_alloc();
+    return packet_ && av_frame_;
+  }
+
+  /** Receive next decoded frame into av_frame_ */
+  bool DecodeNext() {
+    while (true) {
+      auto ret = avcodec_receive_frame(codec_, av_frame_);
+      if (ret == 0) {
+        return true;
+      } else if (ret != AVERROR(EAGAIN) || draining_) {
+        /* End of stream or decoding error */
+        return false;
+      }
+
+      /* Decoder needs more input */
+      if (av_read_frame(format_, packet_) < 0) {
+        /* Flush frames buffered in decoder */
+        draining_ = true;
+        avcodec_send_packet(codec_, nullptr);
+        continue;
+      }
+
+      if (packet_->stream_index == stream_index_) {
+        avcodec_send_packet(codec_, packet_);
+      }
+      av_packet_unref(packet_);
+    }
+  }
+
+  Frame::Timestamp FrameTimestamp() const {
+    auto pts = av_frame_->best_effort_timestamp;
+    if (pts == AV_NOPTS_VALUE) {
+      pts = av_frame_->pts;
+    }
+    if (pts == AV_NOPTS_VALUE) {
+      /* Nothing better available */
+      return frame_.timestamp;
+    }
+    return (pts - start_pts_) * av_q2d(time_base_);
+  }
+
+  /** Convert av_frame_ to BGR into frame_ */
+  void Convert() {
+    const int width = av_frame_->width;
+    const int height = av_frame_->height;
+
+    sws_ = sws_getCachedContext(sws_,
+        width, height, static_cast<AVPixelFormat>(av_frame_->format),
+        width, height, AV_PIX_FMT_BGR24,
+        SWS_BILINEAR, nullptr, nullptr, nullptr);
+    assert(sws_);
+
+    cv::Mat buffer = PoolBuffer(height, width);
+    uint8_t *destination[] = {buffer.data};
+    int destination_stride[] = {static_cast<int>(buffer.step)};
+    sws_scale(sws_, av_frame_->data, av_frame_->linesize, 0, height,
+              destination, destination_stride);
+
+    frame_.timestamp = FrameTimestamp();
+    frame_.data = buffer;
+  }
+
+  cv::Mat PoolBuffer(const int rows, const int cols) {
+    for (auto &buffer : pool_) {
+      if (!IsShared(buffer)) {
+        /* No reallocation for unchanged size */
+        buffer.create(rows, cols, CV_8UC3);
+        return buffer;
+      }
+    }
+
+    if (pool_.size() < kMaxPoolSize) {
+      pool_.push_back(cv::Mat(rows, cols, CV_8UC3));
+      return pool_.back();
+    }
+
+    /* Consumers hold all pooled buffers, don't wait for them. */
+    return cv::Mat(rows, cols, CV_8UC3);
+  }
+};
+
+constexpr double FfmpegFrameIterator::kTimestampTolerance;
+
+
+/* Provider */
+FfmpegVideoProvider::FfmpegVideoProvider(const std::string &filename)
+    : VideoProvider(),
+      filename_(filename) {
+}
+
+FrameIterator FfmpegVideoProvider::begin() {
+  auto ffmpeg_iterator = new FfmpegFrameIterator(filename_);
+  if (ffmpeg_iterator->IsValid()) {
+    ffmpeg_iterator->MoveNext();
+  }
+  return FrameIterator(this, ffmpeg_iterator);
+}
+
+FrameIterator FfmpegVideoProvider::end() {
+  return FrameIterator(this);
+}
+
+FrameIterator FfmpegVideoProvider::Seek(const Frame::Timestamp timestamp) {
+  auto ffmpeg_iterator = new FfmpegFrameIterator(filename_);
+  /* Wrap immediately so that iterator is released on any return */
+  FrameIterator result(this, ffmpeg_iterator);
+
+  if (!ffmpeg_iterator->IsValid() || !ffmpeg_iterator->Seek(timestamp)) {
+    return end();
+  }
+
+  return result;
+}
+
+} // namespace dove_eye
@@ -1,29 +1,136 @@
 #include "dove_eye/file_video_provider.h"
 
 #include <cassert>
+#include <cmath>
 #include <thread>
 
 #include "dove_eye/cv_frame_iterator.h"
 #include "dove_eye/frame_iterator/nonblocking_policy.h"
 #include "dove_eye/frame_iterator/fps_policy.h"
+#include "dove_eye/logging.h"
+
+namespace {
+
+typedef dove_eye::CvFrameIterator<dove_eye::frame_iterator::FpsPolicy,
+                                  dove_eye::frame_iterator::NonblockingPolicy>
+    CvIterator;
+
+} // anonymous namespace
 
 namespace dove_eye {
 
 /* Provider */
 FileVideoProvider::FileVideoProvider(const std::string &filename)
     : VideoProvider(),
-      filename_(filename) {
+      filename_(filename),
+      index_ready_(false),
+      index_cancelled_(false) {
+  /* Building the index decodes whole file, don't block the caller */
+  index_thread_ = std::thread(&FileVideoProvider::OpenIndex, this);
 }
 
-FrameIterator FileVideoProvider::begin() {
-  typedef CvFrameIterator<frame_iterator::FpsPolicy,
-                          frame_iterator::NonblockingPolicy> CvIterator;
+FileVideoProvider::~FileVideoProvider() {
+  index_cancelled_ = true;
+  if (index_thread_.joinable()) {
+    index_thread_.join();
+  }
+}
 
-  return FrameIterator(this, new CvIterator(filename_));
+FrameIterator FileVideoProvider::begin() {
+  auto cv_iterator = new CvIterator(filename_);
+  if (cv_iterator->IsValid()) {
+    cv_iterator->MoveNext();
+  }
+  return FrameIterator(this, cv_iterator);
 }
 
 FrameIterator FileVideoProvider::end() {
   return FrameIterator(this);
 }
 
+FrameIterator FileVideoProvider::Seek(const Frame::Timestamp timestamp) {
+  const bool indexed = index_ready_;
+
+  auto cv_iterator = new CvIterator(filename_);
+  /* Wrap immediately so that iterator is released on any return */
+  FrameIterator result(this, cv_iterator);
+  if (!cv_iterator->IsValid()) {
+    return end();
+  }
+
+  auto &capture = cv_iterator->CvVideoCapture();
+  /* FpsPolicy assigns timestamp (frame_no + 1) * period */
+  auto fps = capture.get(CV_CAP_PROP_FPS);
+  auto frame_position = std::ceil(timestamp * fps - 1 - 1e-6);
+  FrameIndex::FrameNo frame_no =
+      (frame_position > 0) ? static_cast<FrameIndex::FrameNo>(frame_position)
+                           : 0;
+
+  if (indexed && frame_no >= index_.size()) {
+    return end();
+  }
+
+  const bool seeked = indexed ?
+      SeekCapture(&capture, frame_no) :
+      capture.set(CV_CAP_PROP_POS_FRAMES, frame_no);
+  if (!seeked) {
+    ERROR("Seek to frame %zu of '%s' failed", frame_no, filename_.c_str());
+    return end();
+  }
+
+  cv_iterator->Reposition(frame_no);
+  return result;
+}
+
+void FileVideoProvider::OpenIndex() {
+  if (index_.Open(filename_, &index_cancelled_)) {
+    index_ready_ = true;
+  } else if (!index_cancelled_) {
+    ERROR("No frame index for '%s', seeks won't be verified",
+          filename_.c_str());
+  }
+}
+
+/** Position capture so that next grabbed frame is frame_no
+ *
+ * Backend is asked to jump (it starts decoding from the preceding keyframe)
+ * and the landing position is verified against the frame index. When backend
+ * overshoots, earlier position is tried, when it undershoots, remaining
+ * frames are grabbed (without conversion).
+ */
+bool FileVideoProvider::SeekCapture(cv::VideoCapture *capture,
+                                    const FrameIndex::FrameNo frame_no) const {
+  if (frame_no == 0) {
+    return capture->set(CV_CAP_PROP_POS_FRAMES, 0);
+  }
+
+  /* We land at the frame before the target and verify it. */
+  const FrameIndex::FrameNo previous = frame_no - 1;
+  FrameIndex::FrameNo target = previous;
+
+  for (int attempt = 0; attempt < kSeekAttempts; ++attempt) {
+    capture->set(CV_CAP_PROP_POS_FRAMES, target);
+    if (!capture->grab()) {
+      return false;
+    }
+
+    auto current = index_.Find(capture->get(CV_CAP_PROP_POS_MSEC) / 1000);
+    if (current > previous) {
+      auto backoff = (current - previous) << attempt;
+      target = (target > backoff) ? target - backoff : 0;
+      continue;
+    }
+
+    while (current < previous) {
+      if (!capture->grab()) {
+        return false;
+      }
+      ++current;
+    }
+    return true;
+  }
+
+  return false;
+}
+
 } // namespace dove_eye
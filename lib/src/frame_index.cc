@@ -0,0 +1,132 @@
+#include "dove_eye/frame_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+
+#include "dove_eye/cv_capture_lock.h"
+#include "dove_eye/logging.h"
+
+using cv::FileStorage;
+using std::string;
+
+namespace {
+
+size_t FileSize(const string &filename) {
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return 0;
+  }
+  return static_cast<size_t>(file.tellg());
+}
+
+} // anonymous namespace
+
+namespace dove_eye {
+
+bool FrameIndex::Open(const std::string &video_filename,
+                      const std::atomic<bool> *cancel) {
+  auto file_size = FileSize(video_filename);
+  auto index_filename = IndexFilename(video_filename);
+
+  if (Load(index_filename, file_size)) {
+    return true;
+  }
+
+  DEBUG("Building frame index for '%s'", video_filename.c_str());
+  if (!Build(video_filename, cancel)) {
+    return false;
+  }
+  file_size_ = file_size;
+
+  if (!Save(index_filename)) {
+    ERROR("Cannot save frame index '%s'", index_filename.c_str());
+  }
+  return true;
+}
+
+FrameIndex::FrameNo FrameIndex::Find(const Frame::Timestamp timestamp) const {
+  assert(IsValid());
+
+  auto it = std::lower_bound(timestamps_.begin(), timestamps_.end(),
+                             timestamp);
+  if (it == timestamps_.end()) {
+    return timestamps_.size() - 1;
+  }
+
+  FrameNo frame_no = it - timestamps_.begin();
+  if (frame_no > 0 &&
+      timestamp - timestamps_[frame_no - 1] < *it - timestamp) {
+    frame_no -= 1;
+  }
+  return frame_no;
+}
+
+std::string FrameIndex::IndexFilename(const std::string &video_filename) {
+  return video_filename + ".index.yml";
+}
+
+bool FrameIndex::Load(const std::string &filename, const size_t file_size) {
+  FileStorage fs(filename, FileStorage::READ);
+  if (!fs.isOpened()) {
+    return false;
+  }
+
+  double stored_size;
+  fs["file_size"] >> stored_size;
+  /* The video changed since the index was built */
+  if (static_cast<size_t>(stored_size) != file_size) {
+    return false;
+  }
+
+  timestamps_.clear();
+  fs["timestamps"] >> timestamps_;
+  file_size_ = file_size;
+
+  return IsValid();
+}
+
+bool FrameIndex::Save(const std::string &filename) const {
+  FileStorage fs(filename, FileStorage::WRITE);
+  if (!fs.isOpened()) {
+    return false;
+  }
+
+  /* FileStorage cannot store size_t */
+  fs << "file_size" << static_cast<double>(file_size_);
+  fs << "timestamps" << timestamps_;
+  return true;
+}
+
+/** Decode the whole video once and note frame timestamps */
+bool FrameIndex::Build(const std::string &video_filename,
+                       const std::atomic<bool> *cancel) {
+  typedef std::lock_guard<std::mutex> CaptureLock;
+
+  cv::VideoCapture *capture;
+  {
+    CaptureLock lock(cv_capture_mtx);
+    capture = new cv::VideoCapture(video_filename);
+  }
+
+  timestamps_.clear();
+  if (capture->isOpened()) {
+    while (capture->grab()) {
+      if (cancel && *cancel) {
+        timestamps_.clear();
+        break;
+      }
+      timestamps_.push_back(capture->get(CV_CAP_PROP_POS_MSEC) / 1000);
+    }
+  }
+
+  {
+    CaptureLock lock(cv_capture_mtx);
+    delete capture;
+  }
+
+  return IsValid();
+}
+
+} // namespace dove_eye
@@ -1,6 +1,8 @@
 #include "dove_eye/histogram_tracker.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 #include <opencv2/opencv.hpp>
 
@@ -16,6 +18,148 @@ using cv::normalize;
 using cv::Scalar;
 using std::vector;
 
+namespace {
+
+/** Binary image of pixels whose box neighbourhood mean exceeds threshold
+ *
+ * Sums are read from integral image, the cost per pixel doesn't depend on the
+ * radius. Window is clipped at borders (mean of the valid pixels).
+ */
+void BoxThreshold(const cv::Mat &src, const int radius, const double threshold,
+                  cv::Mat *dst) {
+  cv::Mat sum;
+  cv::integral(src, sum, CV_32S);
+
+  dst->create(src.size(), CV_8UC1);
+  for (int y = 0; y < src.rows; ++y) {
+    const int y0 = std::max(0, y - radius);
+    const int y1 = std::min(src.rows, y + radius + 1);
+    const int *top = sum.ptr<int>(y0);
+    const int *bottom = sum.ptr<int>(y1);
+    uchar *out = dst->ptr<uchar>(y);
+
+    for (int x = 0; x < src.cols; ++x) {
+      const int x0 = std::max(0, x - radius);
+      const int x1 = std::min(src.cols, x + radius + 1);
+      const int area = (y1 - y0) * (x1 - x0);
+      const int window_sum = bottom[x1] - bottom[x0] - top[x1] + top[x0];
+      out[x] = (window_sum > threshold * area) ? 255 : 0;
+    }
+  }
+}
+
+struct Blob {
+  int area;
+  int min_x;
+  int min_y;
+  int max_x;
+  int max_y;
+};
+
+int FindRoot(vector<int> *parents, int label) {
+  auto &parent = *parents;
+  while (parent[label] != label) {
+    /* Path halving */
+    parent[label] = parent[parent[label]];
+    label = parent[label];
+  }
+  return label;
+}
+
+/** Bounding box of the largest 8-connected component of binary image
+ *
+ * Single pass labeling with union-find, statistics of provisional labels are
+ * merged at the end (only previous row of labels is kept).
+ *
+ * @return  false when there is no foreground pixel
+ */
+bool LargestBlob(const cv::Mat &binary, cv::Rect *result) {
+  /* Label 0 is the background */
+  vector<int> parents(1, 0);
+  vector<Blob> blobs(1);
+  vector<int> previous(binary.cols + 2, 0);
+  vector<int> current(binary.cols + 2, 0);
+
+  for (int y = 0; y < binary.rows; ++y) {
+    const uchar *row = binary.ptr<uchar>(y);
+    /* Labels are shifted by one, columns -1 and cols are background */
+    for (int x = 0; x < binary.cols; ++x) {
+      if (!row[x]) {
+        current[x + 1] = 0;
+        continue;
+      }
+
+      const int neighbours[] = {
+        current[x], previous[x], previous[x + 1], previous[x + 2]
+      };
+      int label = 0;
+      for (auto neighbour : neighbours) {
+        if (!neighbour) {
+          continue;
+        }
+        const int root = FindRoot(&parents, neighbour);
+        if (!label) {
+          label = root;
+        } else if (root != label) {
+          /* Union, the smaller label becomes the root */
+          parents[std::max(root, label)] = std::min(root, label);
+          label = std::min(root, label);
+        }
+      }
+
+      if (!label) {
+        label = parents.size();
+        parents.push_back(label);
+        blobs.push_back({0, x, y, x, y});
+      }
+
+      auto &blob = blobs[label];
+      blob.area += 1;
+      blob.min_x = std::min(blob.min_x, x);
+      blob.max_x = std::max(blob.max_x, x);
+      blob.min_y = std::min(blob.min_y, y);
+      blob.max_y = std::max(blob.max_y, y);
+      current[x + 1] = label;
+    }
+    std::swap(previous, current);
+  }
+
+  /* Merge statistics of provisional labels into their roots */
+  for (size_t label = 1; label < blobs.size(); ++label) {
+    const size_t root = FindRoot(&parents, label);
+    if (root == label) {
+      continue;
+    }
+    auto &blob = blobs[label];
+    auto &root_blob = blobs[root];
+    root_blob.area += blob.area;
+    root_blob.min_x = std::min(root_blob.min_x, blob.min_x);
+    root_blob.max_x = std::max(root_blob.max_x, blob.max_x);
+    root_blob.min_y = std::min(root_blob.min_y, blob.min_y);
+    root_blob.max_y = std::max(root_blob.max_y, blob.max_y);
+    blob.area = 0;
+  }
+
+  const Blob *best = nullptr;
+  for (size_t label = 1; label < blobs.size(); ++label) {
+    if (blobs[label].area > 0 && (!best || blobs[label].area > best->area)) {
+      best = &blobs[label];
+    }
+  }
+
+  if (!best) {
+    return false;
+  }
+
+  /* Same extent as cv::boundingRect */
+  *result = cv::Rect(best->min_x, best->min_y,
+                     best->max_x - best->min_x + 1,
+                     best->max_y - best->min_y + 1);
+  return true;
+}
+
+} // anonymous namespace
+
 namespace dove_eye {
 
 bool HistogramTracker::InitTrackerData(const cv::Mat &data, const Mark &mark) {
@@ -122,44 +266,42 @@ bool HistogramTracker::Search(
   /* Apply HSV mask before blurring */
   backproj &= hsv_mask;
 
-  /* Gaussiuan blur
-   * sigma = 0 -> calculated from size
+  /*
+   * Box blur in place of Gaussian blur of TEMPLATE_RADIUS kernel (sigma as
+   * OpenCV derives it from the odd size), thresholded in the same pass. Box
+   * area is 2 pi sigma^2, small blobs pass the threshold as with the Gaussian
+   * (box of the same variance dims them more).
    */
-  auto radius = parameters().Get(Parameters::TEMPLATE_RADIUS);
-  cv::Size blur_size(radius, radius);
-
-  blur_size.width += 1 - (blur_size.width % 2);
-  blur_size.height += 1 - (blur_size.height % 2);
+  int blur_size = parameters().Get(Parameters::TEMPLATE_RADIUS);
+  blur_size += 1 - (blur_size % 2);
+  const double sigma = 0.3 * ((blur_size - 1) * 0.5 - 1) + 0.8;
+  const int box_radius = std::max(0,
+                                  cvRound(std::sqrt(CV_PI / 2) * sigma - 0.5));
 
-  cv::GaussianBlur(backproj, backproj, blur_size, 0);
-
-  /* Apply threshold */
-  cv::threshold(backproj, backproj, threshold * 255, 255, cv::THRESH_BINARY);
+  cv::Mat binary;
+  BoxThreshold(backproj, box_radius, threshold * 255, &binary);
 
   /* Apply (motion) mask */
   if (mask) {
     auto mask_roi = (*mask)(extended_roi);
-    backproj &= mask_roi;
+    binary &= mask_roi;
   }
 
-  log_mat(reinterpret_cast<size_t>(this) * 100 + 4, backproj);
+  log_mat(reinterpret_cast<size_t>(this) * 100 + 4, binary);
 
-  ContourVector contours;
-  cv::findContours(backproj, contours,
-                   cv::noArray(), /* hierarchy */
-                   CV_RETR_LIST,
-                   CV_CHAIN_APPROX_SIMPLE);
+  cv::Rect blob;
+  if (!LargestBlob(binary, &blob)) {
+    DEBUG("%s no-blobs", __func__);
+    return false;
+  }
 
 #ifdef CONFIG_DEBUG_HIGHGUI
-  cv::drawContours(data_roi, contours, -1, Scalar(255, 100, 0), 2);
+  cv::rectangle(data_roi, blob, Scalar(255, 100, 0), 2);
 #endif
 
-  if (contours.size() == 0) {
-    DEBUG("%s no-contours", __func__);
-    return false;
-  }
-
-  ContoursToMark(contours, result);
+  result->type = Mark::kRectangle;
+  result->top_left = blob.tl();
+  result->size = blob.br() - blob.tl();
 
   /* Apply ROI offset */
   result->top_left.x += extended_roi.x;
@@ -196,27 +338,4 @@ cv::Mat HistogramTracker::PreprocessImage(const cv::Mat &data,
   return hue;
 }
 
-void HistogramTracker::ContoursToMark(
-    const ContourVector &contours,
-    Mark *mark) const {
-
-  double max_area = 0;
-  const Contour *best_contour;
-
-  for (auto &contour : contours) {
-    auto area = cv::contourArea(contour);
-    if (area < max_area) {
-      continue;
-    }
-    max_area = area;
-    best_contour = &contour;
-  }
-
-  assert(best_contour);
-  auto rect = cv::boundingRect(*best_contour);
-  mark->type = Mark::kRectangle;
-  mark->top_left = rect.tl();
-  mark->size = rect.br() - rect.tl();
-}
-
 } // namespace dove_eye
@@ -0,0 +1,292 @@
+#include "dove_eye/klt_tracker.h"
+
+#include <algorithm>
+
+#include "dove_eye/logging.h"
+
+using cv::cvtColor;
+
+namespace {
+
+float Median(std::vector<float> *values) {
+  auto middle = values->begin() + values->size() / 2;
+  std::nth_element(values->begin(), middle, values->end());
+  return *middle;
+}
+
+} // anonymous namespace
+
+namespace dove_eye {
+
+const size_t KltTracker::kMinFeatures;
+
+KltTracker::KltTracker(const Parameters &parameters,
+                       const InnerTracker &fallback)
+    : InnerTracker(parameters),
+      fallback_(fallback.Clone()),
+      initialized_(false),
+      radius_(0),
+      timestamp_(0),
+      seeded_count_(0) {
+}
+
+KltTracker::KltTracker(const KltTracker &other)
+    : InnerTracker(other),
+      fallback_(other.fallback_->Clone()),
+      initialized_(other.initialized_),
+      radius_(other.radius_),
+      timestamp_(other.timestamp_),
+      seeded_count_(other.seeded_count_) {
+  /* We can copy unitialized object only */
+  assert(!other.initialized());
+}
+
+bool KltTracker::InitializeTracking(const Frame &frame, const Mark mark,
+                                    Posit *result) {
+  if (!fallback_->InitializeTracking(frame, mark, result)) {
+    return false;
+  }
+
+  if (mark.type == Mark::kCircle) {
+    radius_ = mark.radius;
+  } else {
+    radius_ = 0.5 * std::min(mark.size.x, mark.size.y);
+  }
+
+  initialized_ = true;
+  Seed(frame, *result);
+  return true;
+}
+
+bool KltTracker::InitializeTracking(
+    const Frame &frame,
+    const Epiline epiline,
+    const TrackerData &tracker_data,
+    Posit *result) {
+  if (!fallback_->InitializeTracking(frame, epiline, tracker_data, result)) {
+    return false;
+  }
+
+  /* Extent of the object as the fallback matched it */
+  Point2 size;
+  if (fallback_->ObjectSize(&size)) {
+    radius_ = 0.5 * std::min(size.x, size.y);
+  } else {
+    radius_ = parameters().Get(Parameters::TEMPLATE_RADIUS);
+  }
+
+  initialized_ = true;
+  Seed(frame, *result);
+  return true;
+}
+
+bool KltTracker::Track(const Frame &frame, Posit *result) {
+  assert(initialized());
+
+  /*
+   * Fallback's prediction must follow the object, its reinitialization
+   * filters the match with it.
+   */
+  if (TrackFeatures(frame, result)) {
+    fallback_->Observe(frame, *result);
+    return true;
+  }
+
+  Posit expected;
+  (void)fallback_->Predict(frame, &expected);
+  return false;
+}
+
+bool KltTracker::Predict(const Frame &frame, Posit *result) {
+  assert(initialized());
+
+  Posit expected;
+  (void)fallback_->Predict(frame, &expected);
+
+  *result = position_ + velocity_ * (frame.timestamp - timestamp_);
+  return true;
+}
+
+bool KltTracker::TrackFeatures(const Frame &frame, Posit *result) {
+  const auto &params = parameters().snapshot();
+  const int window_size = params.Get(Parameters::KLT_WINDOW);
+  const int levels = params.Get(Parameters::KLT_LEVELS);
+  const auto min_ratio = params.Get(Parameters::KLT_MIN_RATIO);
+  const auto fb_error = params.Get(Parameters::KLT_FB_ERROR);
+
+  if (features_.size() < kMinFeatures) {
+    return false;
+  }
+
+  /* Same window as in the last frame, object moved within it */
+  cv::Mat grey;
+  GreyWindow(frame.data, window_, &grey);
+
+  FeatureVector next;
+  FeatureVector back;
+  std::vector<uchar> status;
+  std::vector<uchar> back_status;
+  std::vector<float> error;
+  const cv::Size win(window_size, window_size);
+  cv::calcOpticalFlowPyrLK(window_grey_, grey, features_, next, status, error,
+                           win, levels);
+  cv::calcOpticalFlowPyrLK(grey, window_grey_, next, back, back_status, error,
+                           win, levels);
+
+  FeatureVector tracked;
+  std::vector<float> dx;
+  std::vector<float> dy;
+  for (size_t i = 0; i < features_.size(); ++i) {
+    if (!status[i] || !back_status[i] ||
+        cv::norm(back[i] - features_[i]) > fb_error) {
+      continue;
+    }
+    tracked.push_back(next[i]);
+    dx.push_back(next[i].x - features_[i].x);
+    dy.push_back(next[i].y - features_[i].y);
+  }
+
+  const size_t min_count = std::max(kMinFeatures,
+                                    size_t(min_ratio * seeded_count_));
+  if (tracked.size() < min_count) {
+    DEBUG("%p->%s lost (%zu/%zu features)", this, __func__, tracked.size(),
+          seeded_count_);
+    return false;
+  }
+
+  /* Median is robust to features on the background */
+  const Point2 shift(Median(&dx), Median(&dy));
+  const auto position = position_ + shift;
+  if (!window_.contains(cv::Point(position))) {
+    return false;
+  }
+
+  const auto dt = frame.timestamp - timestamp_;
+  velocity_ = (dt > 0) ? Point2(shift * (1 / dt)) : Point2();
+  timestamp_ = frame.timestamp;
+  position_ = position;
+
+  /* Recenter the window, keep features that stay on the object */
+  const auto window = WindowAround(frame.data.size(), position_);
+  if (window == window_) {
+    window_grey_ = grey;
+  } else {
+    GreyWindow(frame.data, window, &window_grey_);
+  }
+
+  const cv::Point2f offset(window_.x - window.x, window_.y - window.y);
+  const cv::Point2f center(position_.x - window.x, position_.y - window.y);
+  window_ = window;
+
+  features_.clear();
+  for (auto &feature : tracked) {
+    const auto moved = feature + offset;
+    if (cv::norm(moved - center) <= radius_) {
+      features_.push_back(moved);
+    }
+  }
+
+  if (features_.size() < seeded_count_ / 2) {
+    DetectFeatures();
+  }
+
+  *result = position_;
+  return true;
+}
+
+bool KltTracker::ReinitializeTracking(const Frame &frame, Posit *result) {
+  assert(initialized());
+
+  if (!fallback_->ReinitializeTracking(frame, result)) {
+    return false;
+  }
+
+  Seed(frame, *result);
+  return true;
+}
+
+bool KltTracker::ReinitializeTracking(const Frame &frame,
+                                      const Epiline epiline,
+                                      Posit *result) {
+  assert(initialized());
+
+  if (!fallback_->ReinitializeTracking(frame, epiline, result)) {
+    return false;
+  }
+
+  Seed(frame, *result);
+  return true;
+}
+
+bool KltTracker::ReinitializeTracking(const Frame &frame,
+                                      const Point2 guess,
+                                      Posit *result) {
+  assert(initialized());
+
+  if (!fallback_->ReinitializeTracking(frame, guess, result)) {
+    return false;
+  }
+
+  Seed(frame, *result);
+  return true;
+}
+
+void KltTracker::Seed(const Frame &frame, const Posit posit) {
+  position_ = posit;
+  velocity_ = Point2();
+  timestamp_ = frame.timestamp;
+
+  window_ = WindowAround(frame.data.size(), posit);
+  GreyWindow(frame.data, window_, &window_grey_);
+
+  features_.clear();
+  seeded_count_ = 0;
+  DetectFeatures();
+}
+
+void KltTracker::DetectFeatures() {
+  const size_t max_features = parameters().Get(Parameters::KLT_FEATURES);
+  if (window_grey_.empty() || features_.size() >= max_features) {
+    return;
+  }
+
+  /* Corners on the object, not too close to the existing ones */
+  const int kMinDistance = 3;
+  cv::Mat mask = cv::Mat::zeros(window_grey_.size(), CV_8UC1);
+  const cv::Point center(position_.x - window_.x, position_.y - window_.y);
+  cv::circle(mask, center, radius_, cv::Scalar(255), -1);
+  for (auto &feature : features_) {
+    cv::circle(mask, feature, kMinDistance, cv::Scalar(0), -1);
+  }
+
+  FeatureVector found;
+  cv::goodFeaturesToTrack(window_grey_, found, max_features - features_.size(),
+                          0.01, kMinDistance, mask);
+  features_.insert(features_.end(), found.begin(), found.end());
+
+  seeded_count_ = features_.size();
+  DEBUG("%p->%s %zu features", this, __func__, seeded_count_);
+}
+
+cv::Rect KltTracker::WindowAround(const cv::Size size,
+                                  const Posit posit) const {
+  /* Object may move by its search extent between frames */
+  const auto extent = radius_ * parameters().Get(Parameters::SEARCH_FACTOR);
+  const cv::Rect window(posit.x - extent, posit.y - extent,
+                        2 * extent, 2 * extent);
+  return window & cv::Rect(cv::Point(0, 0), size);
+}
+
+void KltTracker::GreyWindow(const cv::Mat &data, const cv::Rect &window,
+                            cv::Mat *grey) const {
+  if (window.area() == 0) {
+    /* Object left the frame, no features */
+    *grey = cv::Mat(window.size(), CV_8UC1);
+  } else if (data.channels() == 1) {
+    data(window).copyTo(*grey);
+  } else {
+    cvtColor(data(window), *grey, CV_BGR2GRAY);
+  }
+}
+
+} // namespace dove_eye
@@ -0,0 +1,180 @@
+#include "dove_eye/location_publisher.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "config.h"
+#include "dove_eye/logging.h"
+
+static_assert(CONFIG_MAX_ARITY <= DOVE_EYE_RING_MAX_ARITY,
+              "Ring record cannot hold posits of all cameras.");
+
+namespace dove_eye {
+
+LocationPublisher::LocationPublisher(const CameraIndex arity)
+    : arity_(arity),
+      fd_(-1),
+      map_(nullptr),
+      map_size_(0),
+      header_(nullptr),
+      slots_(nullptr),
+      next_record_(0) {
+}
+
+LocationPublisher::~LocationPublisher() {
+  Close();
+}
+
+#ifndef _WIN32
+
+bool LocationPublisher::Open(const std::string &name) {
+  Close();
+
+  /* Start anew, don't inherit counters of a previous publisher. */
+  shm_unlink(name.c_str());
+  fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd_ < 0) {
+    ERROR("Cannot create shared memory '%s': %s", name.c_str(),
+          strerror(errno));
+    return false;
+  }
+
+  map_size_ = sizeof(dove_eye_ring_header) +
+      DOVE_EYE_RING_CAPACITY * sizeof(dove_eye_ring_slot);
+  if (ftruncate(fd_, map_size_) != 0) {
+    ERROR("Cannot resize shared memory '%s': %s", name.c_str(),
+          strerror(errno));
+    close(fd_);
+    fd_ = -1;
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  map_ = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (map_ == MAP_FAILED) {
+    ERROR("Cannot map shared memory '%s': %s", name.c_str(), strerror(errno));
+    map_ = nullptr;
+    close(fd_);
+    fd_ = -1;
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  name_ = name;
+  /* ftruncate zeroed the object, i.e. head and all slot counters. */
+  auto header = static_cast<dove_eye_ring_header *>(map_);
+  header->version = DOVE_EYE_RING_VERSION;
+  header->capacity = DOVE_EYE_RING_CAPACITY;
+  header->slot_size = sizeof(dove_eye_ring_slot);
+  /* Magic last, it tells readers the header is complete. */
+  __atomic_store_n(&header->magic, DOVE_EYE_RING_MAGIC, __ATOMIC_RELEASE);
+
+  header_ = header;
+  slots_ = reinterpret_cast<dove_eye_ring_slot *>(header + 1);
+  next_record_ = 0;
+
+  DEBUG("Publishing locations to '%s'", name_.c_str());
+  return true;
+}
+
+void LocationPublisher::Close() {
+  if (!IsOpen()) {
+    return;
+  }
+
+  munmap(map_, map_size_);
+  close(fd_);
+  shm_unlink(name_.c_str());
+
+  map_ = nullptr;
+  fd_ = -1;
+  header_ = nullptr;
+  slots_ = nullptr;
+}
+
+void LocationPublisher::Publish(const Frameset &frameset,
+                                const Positset &positset,
+                                const Location *location) {
+  assert(frameset.Arity() == arity_);
+  assert(positset.Arity() == arity_);
+
+  if (!IsOpen()) {
+    return;
+  }
+
+  /* Prepare the record aside, the slot is then written in one copy. */
+  dove_eye_ring_record record;
+  std::memset(&record, 0, sizeof(record));
+
+  record.record_no = next_record_;
+  record.sequence_no = frameset.sequence_no;
+  record.arity = arity_;
+
+  bool has_timestamp = false;
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    if (frameset.IsValid(cam)) {
+      record.timestamp = has_timestamp ?
+          std::max(record.timestamp, frameset[cam].timestamp) :
+          frameset[cam].timestamp;
+      has_timestamp = true;
+    }
+
+    if (positset.IsValid(cam)) {
+      record.posit_validity |= 1u << cam;
+      record.posits[cam][0] = positset[cam].x;
+      record.posits[cam][1] = positset[cam].y;
+    }
+  }
+
+  if (location) {
+    record.flags |= DOVE_EYE_RING_LOCATION_VALID;
+    record.location[0] = location->x;
+    record.location[1] = location->y;
+    record.location[2] = location->z;
+  }
+
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  record.publish_time = now.tv_sec + now.tv_nsec * 1e-9;
+
+  /* Seqlock write, see location_ring.h */
+  auto &slot = slots_[next_record_ % DOVE_EYE_RING_CAPACITY];
+  __atomic_store_n(&slot.seq, 2 * next_record_ + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  std::memcpy(&slot.record, &record, sizeof(record));
+
+  __atomic_store_n(&slot.seq, 2 * next_record_ + 2, __ATOMIC_RELEASE);
+
+  next_record_ += 1;
+  __atomic_store_n(&header_->head, next_record_, __ATOMIC_RELEASE);
+}
+
+#else
+
+bool LocationPublisher::Open(const std::string &name) {
+  ERROR("Shared memory publishing is not supported on this platform");
+  return false;
+}
+
+void LocationPublisher::Close() {
+}
+
+void LocationPublisher::Publish(const Frameset &frameset,
+                                const Positset &positset,
+                                const Location *location) {
+}
+
+#endif
+
+} // namespace dove_eye
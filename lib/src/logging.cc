@@ -0,0 +1,417 @@
+#include "dove_eye/logging.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+using std::string;
+
+namespace dove_eye {
+
+/** Single producer (owning thread), single consumer (writer) queue */
+class LogRing {
+ public:
+  static const size_t kCapacity = 256;
+  static const size_t kTextSize = 256;
+
+  struct Record {
+    Logger::Clock::time_point time;
+    LogLevel level;
+    const char *module;
+    int module_length;
+    int line;
+    unsigned thread_no;
+    unsigned suppressed;
+    char text[kTextSize];
+  };
+
+  explicit LogRing(const unsigned thread_no)
+      : thread_no(thread_no),
+        dropped(0),
+        abandoned(false),
+        head_(0),
+        tail_(0) {
+  }
+
+  /** Free record or nullptr when the ring is full */
+  inline Record *Reserve() {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == kCapacity) {
+      return nullptr;
+    }
+    return &records_[head % kCapacity];
+  }
+
+  /** Publish the reserved record */
+  inline void Commit() {
+    head_.store(head_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  inline bool Pop(Record *record) {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *record = records_[tail % kCapacity];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  const unsigned thread_no;
+
+  /** Messages lost because the ring was full */
+  std::atomic<unsigned> dropped;
+
+  /** Owning thread finished, ring is removed once drained */
+  std::atomic<bool> abandoned;
+
+ private:
+  Record records_[kCapacity];
+  std::atomic<size_t> head_;
+  std::atomic<size_t> tail_;
+};
+
+} // namespace dove_eye
+
+namespace {
+
+using dove_eye::LogLevel;
+using dove_eye::LogRing;
+
+struct RingHolder {
+  ~RingHolder() {
+    if (ring) {
+      ring->abandoned = true;
+    }
+  }
+
+  std::shared_ptr<LogRing> ring;
+};
+
+thread_local RingHolder ring_holder;
+
+/** Stops the writer at exit, instance itself is leaked intentionally */
+struct ShutdownGuard {
+  explicit ShutdownGuard(dove_eye::Logger *logger)
+      : logger(logger) {
+  }
+
+  ~ShutdownGuard() {
+    logger->Shutdown();
+  }
+
+  dove_eye::Logger *logger;
+};
+
+const char kLevelNames[][8] = { "debug", "info", "warning", "error", "off" };
+const char kLevelTags[] = "DIWE";
+
+bool ParseLevel(const string &name, LogLevel *level) {
+  for (int i = dove_eye::kLogDebug; i <= dove_eye::kLogOff; ++i) {
+    if (name == kLevelNames[i]) {
+      *level = static_cast<LogLevel>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+string Trim(const string &str) {
+  const auto begin = str.find_first_not_of(" \t");
+  if (begin == string::npos) {
+    return "";
+  }
+  const auto end = str.find_last_not_of(" \t");
+  return str.substr(begin, end - begin + 1);
+}
+
+void FormatRecord(const double time, const LogRing::Record &record,
+                  string *output) {
+  char prefix[64];
+  snprintf(prefix, sizeof(prefix), "%11.6f %c ", time,
+           kLevelTags[record.level]);
+  *output += prefix;
+  output->append(record.module, record.module_length);
+  snprintf(prefix, sizeof(prefix), ":%i T%u: ", record.line, record.thread_no);
+  *output += prefix;
+  *output += record.text;
+  if (record.suppressed > 0) {
+    snprintf(prefix, sizeof(prefix), " (%u similar suppressed)",
+             record.suppressed);
+    *output += prefix;
+  }
+  //TODO Replace "\n" with platform independent constant
+  *output += "\n";
+}
+
+} // anonymous namespace
+
+namespace dove_eye {
+
+/*
+ * LogSite
+ */
+
+std::atomic<unsigned> LogSite::config_version_(1);
+
+LogSite::LogSite(const char *file, const int line, const LogLevel level)
+    : line_(line),
+      level_(level),
+      version_(0),
+      enabled_(false),
+      window_(0),
+      window_count_(0),
+      suppressed_(0) {
+  /* Basename without extension */
+  module_ = file;
+  for (auto c = file; *c; ++c) {
+    if (*c == '/' || *c == '\\') {
+      module_ = c + 1;
+    }
+  }
+  auto dot = std::strchr(module_, '.');
+  module_length_ = dot ? (dot - module_) : std::strlen(module_);
+}
+
+void LogSite::Refresh() {
+  const unsigned version = config_version_;
+  const auto level = Logger::Instance().ModuleLevel(
+      string(module_, module_length_));
+  enabled_.store(level_ >= level, std::memory_order_relaxed);
+  version_.store(version, std::memory_order_relaxed);
+}
+
+bool LogSite::Admit() {
+  const unsigned rate = Logger::Instance().rate_;
+  if (rate == 0) {
+    return true;
+  }
+
+  /* Fixed one second windows, races only shift the limit slightly */
+  const int64_t window = std::chrono::duration_cast<std::chrono::seconds>(
+      Logger::Clock::now().time_since_epoch()).count();
+  if (window_.exchange(window, std::memory_order_relaxed) != window) {
+    window_count_.store(0, std::memory_order_relaxed);
+  }
+
+  if (window_count_.fetch_add(1, std::memory_order_relaxed) < rate) {
+    return true;
+  }
+  suppressed_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+/*
+ * Logger
+ */
+
+const std::chrono::milliseconds Logger::kFlushPeriod(50);
+
+Logger &Logger::Instance() {
+  /* Thread safe initialization (C++11) */
+  static Logger *instance = new Logger();
+  static ShutdownGuard guard(instance);
+  return *instance;
+}
+
+Logger::Logger()
+    : start_(Clock::now()),
+      default_level_(kLogDebug),
+      rate_(kDefaultRate),
+      next_thread_no_(0),
+      stopped_(false),
+      stop_requested_(false) {
+  const char *spec = std::getenv("DOVE_EYE_LOG");
+  if (spec && !Configure(spec)) {
+    /* Logger isn't ready yet */
+    fprintf(stderr, "Invalid DOVE_EYE_LOG '%s'\n", spec);
+  }
+
+  writer_ = std::thread(&Logger::WriterLoop, this);
+}
+
+bool Logger::Configure(const string &spec) {
+  LogLevel default_level = kLogDebug;
+  std::map<string, LogLevel> module_levels;
+  unsigned rate = kDefaultRate;
+
+  std::istringstream input(spec);
+  string item;
+  while (std::getline(input, item, ',')) {
+    item = Trim(item);
+    if (item.empty()) {
+      continue;
+    }
+
+    const auto eq = item.find('=');
+    if (eq == string::npos) {
+      if (!ParseLevel(item, &default_level)) {
+        return false;
+      }
+      continue;
+    }
+
+    const auto key = Trim(item.substr(0, eq));
+    const auto value = Trim(item.substr(eq + 1));
+    if (key == "rate") {
+      char *end;
+      rate = std::strtoul(value.c_str(), &end, 10);
+      if (value.empty() || *end) {
+        return false;
+      }
+    } else if (!ParseLevel(value, &module_levels[key])) {
+      return false;
+    }
+  }
+
+  {
+    Lock lock(config_mtx_);
+    default_level_ = default_level;
+    module_levels_ = module_levels;
+    rate_ = rate;
+  }
+  /* Sites refresh lazily */
+  ++LogSite::config_version_;
+
+  return true;
+}
+
+void Logger::Log(LogSite *site, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+
+  if (stopped_) {
+    vfprintf(stderr, format, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+    return;
+  }
+
+  auto ring = ThreadRing();
+  auto record = ring->Reserve();
+  if (!record) {
+    ++ring->dropped;
+    va_end(args);
+    return;
+  }
+
+  record->time = Clock::now();
+  record->level = site->level();
+  record->module = site->module_;
+  record->module_length = site->module_length_;
+  record->line = site->line();
+  record->thread_no = ring->thread_no;
+  record->suppressed = site->TakeSuppressed();
+  vsnprintf(record->text, sizeof(record->text), format, args);
+  va_end(args);
+
+  ring->Commit();
+
+  if (site->level() >= kLogError) {
+    /* Lost wakeup only delays the message by kFlushPeriod */
+    writer_cv_.notify_one();
+  }
+}
+
+void Logger::Flush() {
+  Drain();
+}
+
+void Logger::Shutdown() {
+  {
+    Lock lock(writer_mtx_);
+    stop_requested_ = true;
+    writer_cv_.notify_all();
+  }
+
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+  stopped_ = true;
+
+  Drain();
+}
+
+LogLevel Logger::ModuleLevel(const string &module) const {
+  Lock lock(config_mtx_);
+  auto it = module_levels_.find(module);
+  return (it != module_levels_.end()) ? it->second : default_level_;
+}
+
+LogRing *Logger::ThreadRing() {
+  if (!ring_holder.ring) {
+    Lock lock(rings_mtx_);
+    ring_holder.ring = std::make_shared<LogRing>(next_thread_no_++);
+    rings_.push_back(ring_holder.ring);
+  }
+  return ring_holder.ring.get();
+}
+
+void Logger::WriterLoop() {
+  Lock lock(writer_mtx_);
+  while (!stop_requested_) {
+    writer_cv_.wait_for(lock, kFlushPeriod);
+
+    lock.unlock();
+    Drain();
+    lock.lock();
+  }
+}
+
+void Logger::Drain() {
+  Lock write_lock(write_mtx_);
+
+  RingVector rings;
+  {
+    Lock lock(rings_mtx_);
+    rings = rings_;
+  }
+
+  std::vector<LogRing::Record> records;
+  string output;
+  LogRing::Record record;
+  for (auto &ring : rings) {
+    /* Abandoned ring receives no more records after this check */
+    const bool abandoned = ring->abandoned;
+    while (ring->Pop(&record)) {
+      records.push_back(record);
+    }
+
+    const auto dropped = ring->dropped.exchange(0);
+    if (dropped > 0) {
+      char line[64];
+      snprintf(line, sizeof(line), "T%u: %u log messages lost\n",
+               ring->thread_no, dropped);
+      output += line;
+    }
+
+    if (abandoned) {
+      Lock lock(rings_mtx_);
+      rings_.erase(std::remove(rings_.begin(), rings_.end(), ring),
+                   rings_.end());
+    }
+  }
+
+  /* Merge threads chronologically */
+  std::stable_sort(records.begin(), records.end(),
+                   [](const LogRing::Record &lhs, const LogRing::Record &rhs) {
+                     return lhs.time < rhs.time;
+                   });
+
+  for (auto &record : records) {
+    const double time = std::chrono::duration<double>(
+        record.time - start_).count();
+    FormatRecord(time, record, &output);
+  }
+
+  if (!output.empty()) {
+    fwrite(output.data(), 1, output.size(), stderr);
+    fflush(stderr);
+  }
+}
+
+} // namespace dove_eye
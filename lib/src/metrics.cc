@@ -0,0 +1,169 @@
+#include "dove_eye/metrics.h"
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+#include "dove_eye/logging.h"
+
+using std::string;
+
+namespace dove_eye {
+
+Metrics &Metrics::Instance() {
+  /* Thread safe initialization (C++11) */
+  static Metrics instance;
+  return instance;
+}
+
+Metrics::Metrics()
+    : dump_stop_requested_(false) {
+}
+
+Metrics::~Metrics() {
+  StopDump();
+}
+
+Counter &Metrics::GetCounter(const string &name, const string &labels,
+                             const string &help) {
+  return *GetEntry(kCounter, name, labels, help).counter;
+}
+
+Gauge &Metrics::GetGauge(const string &name, const string &labels,
+                         const string &help) {
+  return *GetEntry(kGauge, name, labels, help).gauge;
+}
+
+Metrics::SampleVector Metrics::Samples() const {
+  SampleVector result;
+
+  Lock lock(mtx_);
+  for (auto &key_entry : entries_) {
+    auto &entry = key_entry.second;
+    const double value = (entry.type == kCounter) ?
+        entry.counter->Value() : entry.gauge->Value();
+    result.push_back({entry.name, entry.labels, entry.type, value});
+  }
+
+  return result;
+}
+
+void Metrics::WritePrometheus(std::ostream &out) const {
+  const auto samples = Samples();
+
+  std::map<string, string> helps;
+  {
+    Lock lock(mtx_);
+    helps = helps_;
+  }
+
+  out << std::setprecision(std::numeric_limits<double>::digits10 + 1);
+
+  /* Samples of a metric are adjacent (ordered by name{labels}) */
+  string last_name;
+  for (auto &sample : samples) {
+    if (sample.name != last_name) {
+      out << "# HELP " << sample.name << " " << helps[sample.name] << "\n";
+      out << "# TYPE " << sample.name << " " <<
+          ((sample.type == kCounter) ? "counter" : "gauge") << "\n";
+      last_name = sample.name;
+    }
+
+    out << sample.name;
+    if (!sample.labels.empty()) {
+      out << "{" << sample.labels << "}";
+    }
+    out << " " << sample.value << "\n";
+  }
+}
+
+bool Metrics::WriteFile(const string &filename) const {
+  const string temporary = filename + ".tmp";
+  {
+    std::ofstream file(temporary);
+    WritePrometheus(file);
+    if (!file) {
+      return false;
+    }
+  }
+
+  /* Rename doesn't replace existing file on some platforms */
+  if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+    std::remove(filename.c_str());
+    return std::rename(temporary.c_str(), filename.c_str()) == 0;
+  }
+  return true;
+}
+
+void Metrics::StartDump(const string &filename, const double interval) {
+  StopDump();
+
+  dump_stop_requested_ = false;
+  dump_thread_ = std::thread(&Metrics::DumpLoop, this, filename, interval);
+}
+
+void Metrics::StopDump() {
+  {
+    Lock lock(dump_mtx_);
+    dump_stop_requested_ = true;
+    dump_cv_.notify_all();
+  }
+
+  if (dump_thread_.joinable()) {
+    dump_thread_.join();
+  }
+}
+
+string Metrics::CamLabel(const CameraIndex cam) {
+  return "cam=\"" + std::to_string(cam) + "\"";
+}
+
+Metrics::Entry &Metrics::GetEntry(const Type type, const string &name,
+                                  const string &labels, const string &help) {
+  const string key = name + "{" + labels + "}";
+
+  Lock lock(mtx_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    /* The same name must keep its type */
+    assert(it->second.type == type);
+    return it->second;
+  }
+
+  auto &entry = entries_[key];
+  entry.type = type;
+  entry.name = name;
+  entry.labels = labels;
+  if (type == kCounter) {
+    entry.counter.reset(new Counter());
+  } else {
+    entry.gauge.reset(new Gauge());
+  }
+  helps_[name] = help;
+
+  return entry;
+}
+
+void Metrics::DumpLoop(const string filename, const double interval) {
+  const std::chrono::duration<double> period(interval);
+
+  Lock lock(dump_mtx_);
+  while (!dump_stop_requested_) {
+    lock.unlock();
+    if (!WriteFile(filename)) {
+      ERROR("Cannot write metrics to '%s'", filename.c_str());
+    }
+    lock.lock();
+
+    dump_cv_.wait_for(lock, period, [&] { return dump_stop_requested_; });
+  }
+
+  /* Final values */
+  lock.unlock();
+  (void)WriteFile(filename);
+}
+
+} // namespace dove_eye
@@ -0,0 +1,296 @@
+#include "dove_eye/mosse_tracker.h"
+
+#include <cmath>
+
+#include "dove_eye/logging.h"
+
+using cv::cvtColor;
+using cv::dft;
+using cv::idft;
+using cv::minMaxLoc;
+using cv::mulSpectrums;
+
+namespace {
+
+/** Regularization of the filter denominator */
+const double kEpsilon = 1e-2;
+
+/** Half size of the peak excluded from sidelobe */
+const int kPeakRadius = 5;
+
+/** Rotations of the initial patch [deg], more samples for the first filter */
+const double kInitRotations[] = { 0, -8, -4, 4, 8 };
+
+cv::Mat GreyPatch(const cv::Mat &data, const dove_eye::Point2 center,
+                  const cv::Size size) {
+  cv::Mat patch;
+  cv::getRectSubPix(data, size, center, patch);
+  if (patch.channels() == 1) {
+    return patch;
+  }
+
+  cv::Mat grey;
+  cvtColor(patch, grey, CV_BGR2GRAY);
+  return grey;
+}
+
+/** Log transform and normalization (optionally windowed) of grey image */
+cv::Mat Preprocess(const cv::Mat &grey, const cv::Mat *window) {
+  cv::Mat result;
+  grey.convertTo(result, CV_32F);
+  cv::log(result + 1, result);
+
+  cv::Scalar mean;
+  cv::Scalar stddev;
+  cv::meanStdDev(result, mean, stddev);
+  result = (result - mean[0]) / (stddev[0] + 1e-5);
+
+  if (window) {
+    result = result.mul(*window);
+  }
+  return result;
+}
+
+/** Spectrum of Gaussian peak at the origin (wrapped around) */
+cv::Mat DesiredResponse(const cv::Size size, const double sigma) {
+  cv::Mat response(size, CV_32F);
+  for (int y = 0; y < size.height; ++y) {
+    const int dy = std::min(y, size.height - y);
+    for (int x = 0; x < size.width; ++x) {
+      const int dx = std::min(x, size.width - x);
+      response.at<float>(y, x) = std::exp(-0.5 * (dx * dx + dy * dy) /
+                                          (sigma * sigma));
+    }
+  }
+
+  cv::Mat spectrum;
+  dft(response, spectrum, cv::DFT_COMPLEX_OUTPUT);
+  return spectrum;
+}
+
+/** Numerator and denominator of the filter learned from single patch */
+void Learn(const cv::Mat &patch, const cv::Mat &response,
+           cv::Mat *numerator, cv::Mat *denominator) {
+  cv::Mat spectrum;
+  dft(patch, spectrum, cv::DFT_COMPLEX_OUTPUT);
+
+  mulSpectrums(response, spectrum, *numerator, 0, true);
+
+  cv::Mat power;
+  mulSpectrums(spectrum, spectrum, power, 0, true);
+  cv::Mat planes[2];
+  cv::split(power, planes);
+  *denominator = planes[0];
+}
+
+double PeakToSidelobe(const cv::Mat &response, const cv::Point peak,
+                      const double peak_value, const cv::Mat *mask) {
+  cv::Mat sidelobe;
+  if (mask) {
+    sidelobe = (*mask != 0);
+  } else {
+    sidelobe = cv::Mat(response.size(), CV_8UC1, cv::Scalar(255));
+  }
+  cv::rectangle(sidelobe,
+                cv::Rect(peak.x - kPeakRadius, peak.y - kPeakRadius,
+                         2 * kPeakRadius + 1, 2 * kPeakRadius + 1),
+                cv::Scalar(0), -1);
+
+  cv::Scalar mean;
+  cv::Scalar stddev;
+  cv::meanStdDev(response, mean, stddev, sidelobe);
+  return (peak_value - mean[0]) / std::max(stddev[0], 1e-5);
+}
+
+} // anonymous namespace
+
+namespace dove_eye {
+
+const double MosseTracker::kPadding = 2;
+
+bool MosseTracker::InitTrackerData(const cv::Mat &data, const Mark &mark) {
+  const auto radius = (mark.type == Mark::kRectangle) ?
+      0.5 * std::min(mark.size.x, mark.size.y) : mark.radius;
+  const auto center = MarkToPosit(mark);
+  const cv::Rect frame_rect(cv::Point(0, 0), data.size());
+  if (radius < 1 || !frame_rect.contains(cv::Point(center))) {
+    return false;
+  }
+
+  const int extent = cv::getOptimalDFTSize(2 * kPadding * radius);
+  const auto sigma = parameters().Get(Parameters::MOSSE_SIGMA);
+
+  /* New object, forget the old filter */
+  data_.size = cv::Size(extent, extent);
+  data_.radius = radius;
+  cv::createHanningWindow(data_.window, data_.size, CV_32F);
+  data_.response = DesiredResponse(data_.size, sigma);
+
+  const auto grey = GreyPatch(data, center, data_.size);
+  const Point2 patch_center(0.5 * extent, 0.5 * extent);
+
+  data_.numerator = cv::Mat::zeros(data_.size, CV_32FC2);
+  data_.denominator = cv::Mat::zeros(data_.size, CV_32F);
+  cv::Mat rotated;
+  cv::Mat numerator;
+  cv::Mat denominator;
+  for (auto angle : kInitRotations) {
+    const auto rotation = cv::getRotationMatrix2D(patch_center, angle, 1);
+    cv::warpAffine(grey, rotated, rotation, data_.size, cv::INTER_LINEAR,
+                   cv::BORDER_REFLECT);
+
+    Learn(Preprocess(rotated, &data_.window), data_.response,
+          &numerator, &denominator);
+    data_.numerator += numerator;
+    data_.denominator += denominator;
+  }
+
+  UpdateFilter(&data_);
+
+  DEBUG("%p->%s(data, %f@[%f,%f]) filter %ix%i", this, __func__,
+        radius, center.x, center.y, extent, extent);
+  return true;
+}
+
+bool MosseTracker::Search(
+      const cv::Mat &data,
+      TrackerData &tracker_data,
+      const cv::Rect *roi,
+      const cv::Mat *mask,
+      const double threshold,
+      Mark *result) const {
+  const auto &filter_data = static_cast<const FilterData &>(tracker_data);
+  assert(!filter_data.filter.empty());
+
+  const auto &size = filter_data.size;
+  Point2 match_point;
+  double psr;
+
+  if (roi && !mask && roi->width <= size.width &&
+      roi->height <= size.height) {
+    /* ROI fits into the filter, single correlation in frequency domain */
+    const Point2 center(roi->x + 0.5 * roi->width,
+                        roi->y + 0.5 * roi->height);
+    const auto patch = Preprocess(GreyPatch(data, center, size),
+                                  &filter_data.window);
+
+    cv::Mat spectrum;
+    dft(patch, spectrum, cv::DFT_COMPLEX_OUTPUT);
+    mulSpectrums(spectrum, filter_data.filter, spectrum, 0);
+
+    cv::Mat response;
+    idft(spectrum, response, cv::DFT_SCALE | cv::DFT_REAL_OUTPUT);
+
+    double peak_value;
+    cv::Point peak;
+    minMaxLoc(response, nullptr, &peak_value, nullptr, &peak);
+    psr = PeakToSidelobe(response, peak, peak_value, nullptr);
+
+    /* Response is periodic, peak at the origin means no shift */
+    const int dx = (peak.x > size.width / 2) ? peak.x - size.width : peak.x;
+    const int dy = (peak.y > size.height / 2) ? peak.y - size.height : peak.y;
+    match_point = center + Point2(dx, dy);
+  } else {
+    /* Large region, correlation with spatial kernel */
+    auto region = cv::Rect(cv::Point(0, 0), data.size());
+    if (roi) {
+      region &= *roi;
+    }
+    if (region.area() == 0) {
+      DEBUG("%p->%s empty-roi", this, __func__);
+      return false;
+    }
+
+    cv::Mat grey;
+    if (data.channels() == 1) {
+      grey = data(region);
+    } else {
+      cvtColor(data(region), grey, CV_BGR2GRAY);
+    }
+
+    cv::Mat response;
+    cv::filter2D(Preprocess(grey, nullptr), response, CV_32F,
+                 filter_data.kernel);
+
+    cv::Mat cropped_mask;
+    if (mask) {
+      cropped_mask = (*mask)(region);
+    }
+
+    double peak_value;
+    cv::Point peak;
+    /* Empty mask doesn't restrict */
+    minMaxLoc(response, nullptr, &peak_value, nullptr, &peak, cropped_mask);
+    psr = PeakToSidelobe(response, peak, peak_value,
+                         mask ? &cropped_mask : nullptr);
+    match_point = Point2(peak.x + region.x, peak.y + region.y);
+  }
+
+  const double value = Score(psr);
+  if (value <= threshold) {
+    DEBUG("%p->%s low value (%f/%f), PSR %f", this, __func__, value,
+          threshold, psr);
+    return false;
+  }
+
+  result->type = Mark::kCircle;
+  result->center = match_point;
+  result->radius = filter_data.radius;
+
+  DEBUG("%p->%s matched (%f/%f), PSR %f", this, __func__, value, threshold,
+        psr);
+  return true;
+}
+
+void MosseTracker::UpdateTrackerData(const cv::Mat &data, const Mark &match) {
+  const auto rate = parameters().Get(Parameters::MOSSE_RATE);
+  if (rate <= 0) {
+    return;
+  }
+
+  const auto grey = GreyPatch(data, match.center, data_.size);
+  cv::Mat numerator;
+  cv::Mat denominator;
+  Learn(Preprocess(grey, &data_.window), data_.response,
+        &numerator, &denominator);
+
+  data_.numerator = (1 - rate) * data_.numerator + rate * numerator;
+  data_.denominator = (1 - rate) * data_.denominator + rate * denominator;
+
+  UpdateFilter(&data_);
+}
+
+void MosseTracker::UpdateFilter(FilterData *filter_data) const {
+  /* Denominator is real, divide both parts of the numerator */
+  cv::Mat planes[2];
+  cv::split(filter_data->numerator, planes);
+  const cv::Mat denominator = filter_data->denominator + kEpsilon;
+  planes[0] /= denominator;
+  planes[1] /= denominator;
+  cv::merge(planes, 2, filter_data->filter);
+
+  /*
+   * Product of spectra is a circular convolution, as correlation (filter2D)
+   * the kernel is point reflected around the origin. Patches are centered at
+   * the object, so the filter2D anchor (center) aligns the peak with it.
+   */
+  cv::Mat spatial;
+  idft(filter_data->filter, spatial, cv::DFT_SCALE | cv::DFT_REAL_OUTPUT);
+
+  const auto &size = filter_data->size;
+  filter_data->kernel.create(size, CV_32F);
+  for (int y = 0; y < size.height; ++y) {
+    const int src_y = (size.height - y) % size.height;
+    for (int x = 0; x < size.width; ++x) {
+      const int src_x = (size.width - x) % size.width;
+      filter_data->kernel.at<float>(y, x) = spatial.at<float>(src_y, src_x);
+    }
+  }
+}
+
+double MosseTracker::Score(const double psr) const {
+  const auto psr_half = parameters().Get(Parameters::MOSSE_PSR);
+  return std::max(0.0, psr) / (std::max(0.0, psr) + psr_half);
+}
+
+} // namespace dove_eye
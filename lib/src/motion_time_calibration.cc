@@ -0,0 +1,286 @@
+#include "dove_eye/motion_time_calibration.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "dove_eye/logging.h"
+
+using cv::Mat;
+using std::vector;
+
+namespace dove_eye {
+
+MotionTimeCalibration::MotionTimeCalibration(Parameters &parameters,
+                                             const CameraIndex arity)
+    : parameters_(parameters),
+      arity_(arity),
+      samples_(arity),
+      previous_(arity),
+      result_(arity) {
+  Reset();
+}
+
+bool MotionTimeCalibration::MeasureFrameset(const Frameset &frameset) {
+  assert(frameset.Arity() == arity_);
+
+  if (arity_ < 2) {
+    return false;
+  }
+
+  const double window = parameters_.Get(Parameters::TIMECALIB_WINDOW);
+
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    if (!frameset.IsValid(cam)) {
+      continue;
+    }
+
+    auto &samples = samples_[cam];
+    const Frame &frame = frameset[cam];
+
+    if (!samples.empty() && frame.timestamp <= samples.back().timestamp) {
+      continue;
+    }
+
+    double energy;
+    if (!MotionEnergy(cam, frame.data, &energy)) {
+      continue;
+    }
+
+    samples.push_back({frame.timestamp, energy});
+    /* Keep memory bounded when some camera does not deliver. */
+    while (samples.front().timestamp < frame.timestamp - 2 * window) {
+      samples.pop_front();
+    }
+  }
+
+  if (state_ == kUnitialized) {
+    state_ = kCollecting;
+  }
+
+  /* Common time range of all cameras */
+  auto start = std::numeric_limits<Frame::Timestamp>::lowest();
+  auto end = std::numeric_limits<Frame::Timestamp>::max();
+  for (auto &samples : samples_) {
+    if (samples.size() < 2) {
+      return false;
+    }
+    start = std::max(start, samples.front().timestamp);
+    end = std::min(end, samples.back().timestamp);
+  }
+
+  if (end - start < window) {
+    return false;
+  }
+
+  bool result = Estimate(end - window, end);
+
+  /*
+   * Old samples were aligned with the old offsets, start with a fresh window
+   * (motion energy continues from previous frames).
+   */
+  for (auto &samples : samples_) {
+    samples.clear();
+  }
+
+  return result;
+}
+
+void MotionTimeCalibration::Reset() {
+  state_ = kUnitialized;
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    samples_[cam].clear();
+    previous_[cam] = Mat();
+    result_[cam] = 0;
+  }
+}
+
+MotionTimeCalibration::ResultType MotionTimeCalibration::Result(
+    const CameraIndex cam) const {
+  assert(state_ == kReady);
+  assert(cam < arity_);
+  return result_[cam];
+}
+
+bool MotionTimeCalibration::MotionEnergy(const CameraIndex cam,
+                                         const cv::Mat &data,
+                                         double *energy) {
+  assert(energy);
+  if (data.empty()) {
+    return false;
+  }
+
+  /* Area interpolation averages out most of the sensor noise. */
+  const int height = std::max(1, data.rows * kSignalWidth / data.cols);
+  Mat small;
+  cv::resize(data, small, cv::Size(kSignalWidth, height), 0, 0,
+             cv::INTER_AREA);
+
+  Mat gray;
+  if (small.channels() == 3) {
+    cv::cvtColor(small, gray, CV_BGR2GRAY);
+  } else {
+    gray = small;
+  }
+
+  auto &previous = previous_[cam];
+  bool result = false;
+  if (previous.size() == gray.size()) {
+    Mat difference;
+    cv::absdiff(gray, previous, difference);
+    *energy = cv::mean(difference)[0];
+    result = true;
+  }
+
+  previous = gray;
+  return result;
+}
+
+bool MotionTimeCalibration::Estimate(const Frame::Timestamp start,
+                                     const Frame::Timestamp end) {
+  const double rate = parameters_.Get(Parameters::TIMECALIB_RATE);
+  const double min_correlation =
+      parameters_.Get(Parameters::TIMECALIB_MIN_CORRELATION);
+  const int length = static_cast<int>((end - start) * rate);
+
+  if (length < 4) {
+    return false;
+  }
+
+  vector<Mat> signals(arity_);
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    Resample(samples_[cam], start, rate, length, &signals[cam]);
+  }
+
+  vector<ResultType> offsets(arity_);
+  auto min_offset = std::numeric_limits<ResultType>::max();
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    double lag = 0;
+    if (cam > 0 &&
+        !CrossCorrelate(signals[cam], signals[0], min_correlation, &lag)) {
+      DEBUG("Time calibration of camera %i failed", cam);
+      return false;
+    }
+
+    offsets[cam] = parameters_.Get(Parameters::CAM_OFFSET, cam) + lag / rate;
+    min_offset = std::min(min_offset, offsets[cam]);
+  }
+
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    offsets[cam] -= min_offset;
+    auto key = static_cast<Parameters::Key>(Parameters::CAM_OFFSET + cam);
+    if (!parameters_.Set(key, offsets[cam])) {
+      ERROR("Time offset %f of camera %i out of range", offsets[cam], cam);
+      return false;
+    }
+    DEBUG("Camera %i time offset %f s", cam, offsets[cam]);
+  }
+
+  result_ = offsets;
+  state_ = kReady;
+  return true;
+}
+
+/** Linearly interpolate samples on uniform grid */
+void MotionTimeCalibration::Resample(const SampleQueue &samples,
+                                     const Frame::Timestamp start,
+                                     const double rate,
+                                     const int length,
+                                     cv::Mat *signal) const {
+  assert(signal);
+  assert(samples.size() >= 2);
+
+  signal->create(1, length, CV_32F);
+  float *data = signal->ptr<float>(0);
+
+  size_t i = 0;
+  for (int n = 0; n < length; ++n) {
+    const Frame::Timestamp t = start + n / rate;
+    while (i + 2 < samples.size() && samples[i + 1].timestamp < t) {
+      ++i;
+    }
+
+    const Sample &s0 = samples[i];
+    const Sample &s1 = samples[i + 1];
+    double alpha = (t - s0.timestamp) / (s1.timestamp - s0.timestamp);
+    alpha = std::min(1.0, std::max(0.0, alpha));
+    data[n] = (1 - alpha) * s0.energy + alpha * s1.energy;
+  }
+}
+
+/** Find lag (in samples) that signal is delayed after reference
+ *
+ * Signals are normalized, so that correlation peak is comparable with
+ * min_correlation (Pearson coefficient).
+ */
+bool MotionTimeCalibration::CrossCorrelate(const cv::Mat &signal,
+                                           const cv::Mat &reference,
+                                           const double min_correlation,
+                                           double *lag) const {
+  assert(lag);
+  assert(signal.cols == reference.cols);
+
+  const int length = signal.cols;
+  const int padded_length = cv::getOptimalDFTSize(2 * length);
+
+  Mat normalized[2];
+  const Mat *inputs[] = {&signal, &reference};
+  for (int i = 0; i < 2; ++i) {
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(*inputs[i], mean, stddev);
+    if (stddev[0] < 1e-6) {
+      /* No motion, nothing to correlate */
+      return false;
+    }
+
+    normalized[i] = Mat::zeros(1, padded_length, CV_32F);
+    Mat head = normalized[i].colRange(0, length);
+    inputs[i]->convertTo(head, CV_32F, 1 / stddev[0], -mean[0] / stddev[0]);
+  }
+
+  Mat spectrum_signal, spectrum_reference, spectrum, correlation;
+  cv::dft(normalized[0], spectrum_signal);
+  cv::dft(normalized[1], spectrum_reference);
+  cv::mulSpectrums(spectrum_signal, spectrum_reference, spectrum, 0, true);
+  cv::idft(spectrum, correlation, cv::DFT_SCALE | cv::DFT_REAL_OUTPUT);
+
+  const float *values = correlation.ptr<float>(0);
+  auto value_at = [&](int k) -> double {
+    return values[(k + padded_length) % padded_length];
+  };
+
+  /* Require at least half of the window to overlap */
+  const int max_lag = length / 2;
+  int best_lag = 0;
+  double best_value = std::numeric_limits<double>::lowest();
+  for (int k = -max_lag; k <= max_lag; ++k) {
+    auto value = value_at(k) / (length - std::abs(k));
+    if (value > best_value) {
+      best_value = value;
+      best_lag = k;
+    }
+  }
+
+  if (best_value < min_correlation) {
+    DEBUG("Weak motion correlation %f", best_value);
+    return false;
+  }
+
+  /* Sub-sample refinement with parabola through neighbouring values */
+  double refinement = 0;
+  if (std::abs(best_lag) < max_lag) {
+    auto left = value_at(best_lag - 1);
+    auto center = value_at(best_lag);
+    auto right = value_at(best_lag + 1);
+    auto denominator = left - 2 * center + right;
+    if (denominator < 0) {
+      refinement = 0.5 * (left - right) / denominator;
+    }
+  }
+
+  *lag = best_lag + refinement;
+  return true;
+}
+
+} // namespace dove_eye
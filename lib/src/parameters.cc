@@ -1,6 +1,7 @@
 #include "dove_eye/parameters.h"
 
 #include <sstream>
+#include <utility>
 
 #define DEFINE_PARAM(KEY, NAME, DEFAULT, UNIT, MIN_VAL, MAX_VAL) \
     {Parameters::KEY, Parameters::KEY, NAME, DEFAULT, UNIT,      \
@@ -17,8 +18,16 @@ namespace dove_eye {
 const Parameters::Parameter Parameters::parameters[] = {
   DEFINE_PARAM(
       TEMPLATE_RADIUS,        "track.template.radius",    45,       "px", 2, 100),
+  DEFINE_PARAM(
+      TEMPLATE_COUNT,         "track.template.count",      4,         "",    1, 16),
+  DEFINE_PARAM(
+      TEMPLATE_UPDATE,        "track.template.update",   0.8,         "",    0, 1),
   DEFINE_PARAM(
       SEARCH_FACTOR,          "track.search.factor",       3,         "",    2, 10),
+  DEFINE_PARAM(
+      SEARCH_MIN_FACTOR,      "track.search.min_factor", 1.5,         "",    1, 10),
+  DEFINE_PARAM(
+      SEARCH_SIGMA,           "track.search.sigma",        3,         "",    1, 10),
   DEFINE_PARAM(
       SEARCH_THRESHOLD,       "track.search.threshold",  0.5,         "",    0, 1),
   DEFINE_PARAM(
@@ -27,6 +36,32 @@ const Parameters::Parameter Parameters::parameters[] = {
       SEARCH_KF_PROC_V,       "track.search.kf.proc_v",  1e-2,     "px?",    1e-4, 1),
   DEFINE_PARAM(
       SEARCH_KF_OBS_V,        "track.search.kf.obs_v",      1,     "px?",    1e-2, 10),
+  DEFINE_PARAM(
+      KLT_FEATURES,           "track.klt.features",       40,         "",    4, 200),
+  DEFINE_PARAM(
+      KLT_WINDOW,             "track.klt.window",         15,       "px",    5, 51),
+  DEFINE_PARAM(
+      KLT_LEVELS,             "track.klt.levels",          2,         "",    0, 5),
+  DEFINE_PARAM(
+      KLT_MIN_RATIO,          "track.klt.min_ratio",     0.3,         "",    0, 1),
+  DEFINE_PARAM(
+      KLT_FB_ERROR,           "track.klt.fb_error",        1,       "px",  0.1, 10),
+  DEFINE_PARAM(
+      MOSSE_RATE,             "track.mosse.rate",      0.125,         "",    0, 1),
+  DEFINE_PARAM(
+      MOSSE_SIGMA,            "track.mosse.sigma",         2,       "px",  0.5, 10),
+  DEFINE_PARAM(
+      MOSSE_PSR,              "track.mosse.psr",           8,         "",    1, 50),
+  DEFINE_PARAM(
+      FUSED_KF_PROC_V,        "track.fused.kf.proc_v",   1e-4,    "m^2",    1e-8, 1),
+  DEFINE_PARAM(
+      FUSED_KF_OBS_V,         "track.fused.kf.obs_v",    1e-4,    "m^2",    1e-8, 1),
+  DEFINE_PARAM(
+      DECIMATION_MAX,         "track.decimation.max",      1, "frame(s)",    1, 16),
+  DEFINE_PARAM(
+      DECIMATION_MOTION,      "track.decimation.motion",   2,     "px/f",    0, 50),
+  DEFINE_PARAM(
+      TRACK_BUDGET,           "track.budget",              0,     "ms/s",    0, 1000),
   DEFINE_PARAM(
       AGGREGATOR_WINDOW,      "aggregator.window",       0.1,        "s",   0, 5),
   DEFINE_PARAM_ARRAY(
@@ -41,11 +76,27 @@ const Parameters::Parameter Parameters::parameters[] = {
       CALIBRATION_FRAMES,     "calibration.frames",       10, "frame(s)",   10, 100),
   DEFINE_PARAM(
       CALIBRATION_SKIP,       "calibration.skip",         15, "frame(s)",    0, 50),
+  DEFINE_PARAM(
+      TIMECALIB_WINDOW,       "calibration.time.window",  10,        "s",    2, 60),
+  DEFINE_PARAM(
+      TIMECALIB_RATE,         "calibration.time.rate",    60,       "Hz",   10, 240),
+  DEFINE_PARAM(
+      TIMECALIB_MIN_CORRELATION, "calibration.time.min_corr", 0.5,   "",    0, 1),
+  DEFINE_PARAM(
+      PREVIEW_WIDTH,          "view.preview.width",      640,       "px",   80, 1920),
+  DEFINE_PARAM(
+      PREVIEW_RATE,           "view.preview.rate",        15,       "Hz",    0, 60),
+  DEFINE_PARAM(
+      METRICS_INTERVAL,       "metrics.interval",          5,        "s",    1, 3600),
 
   {Parameters::_MAX_KEY, Parameters::_MAX_KEY}
 };
 
-Parameters::Parameters() {
+Parameters::Parameters()
+    : values_(nullptr) {
+  std::unique_ptr<Snapshot::Values> initial(new Snapshot::Values());
+  initial->version = 0;
+
   size_t i = 0;
   while (true) {
     const Parameter &param = Parameters::parameters[i];
@@ -57,6 +108,7 @@ Parameters::Parameters() {
     for (size_t key = param.key; key <= param.last_key; ++key) {
       parameters_[key] = param;
       parameters_[key].key = static_cast<Key>(key);
+      initial->values[key] = param.value;
 
       if (param.key != param.last_key) {
         stringstream ss;
@@ -67,33 +119,36 @@ Parameters::Parameters() {
     }
     ++i;
   }
+
+  published_.emplace_back(std::move(initial));
+  values_.store(published_.back().get(), std::memory_order_release);
 }
 
 bool Parameters::Set(const Key key, const double value) {
   assert(key < _MAX_KEY);
 
-  std::lock_guard<std::mutex> lock(parameters_mtx_);
   if (value < parameters_[key].min_value ||
       value > parameters_[key].max_value) {
     return false;
   }
 
-  parameters_[key].value = value;
-  return true;
-}
-
-double Parameters::Get(const Key key) const {
-  assert(key < _MAX_KEY);
-
-  /* Alas in C++11, no shared_lock available... */
-  std::lock_guard<std::mutex> lock(parameters_mtx_);
-  return parameters_[key].value;
-}
+  std::lock_guard<std::mutex> lock(writers_mtx_);
+  const auto &current = *published_.back();
+  if (current.values[key] == value) {
+    return true;
+  }
 
+  /*
+   * Copy-on-write, readers see either old or new snapshot. The old values
+   * stay allocated, any snapshot may still refer to them.
+   */
+  std::unique_ptr<Snapshot::Values> updated(new Snapshot::Values(current));
+  updated->version += 1;
+  updated->values[key] = value;
 
-double Parameters::Get(const Key key, const size_t offset) const {
-  auto new_key = static_cast<size_t>(key) + offset;
-  return Get(static_cast<Key>(new_key));
+  published_.emplace_back(std::move(updated));
+  values_.store(published_.back().get(), std::memory_order_release);
+  return true;
 }
 
 } // namespace dove_eye
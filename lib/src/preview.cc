@@ -0,0 +1,132 @@
+#include "dove_eye/preview.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+#include "dove_eye/logging.h"
+
+using cv::Mat;
+using std::vector;
+
+namespace {
+
+/** Output channel c is taken from input channel kRgbFromBgr[c] */
+const int kRgbFromBgr[3] = {2, 1, 0};
+
+} // anonymous namespace
+
+namespace dove_eye {
+
+void DownscaleToRgb(const Mat &src, const int factor, Mat *dst) {
+  assert(src.depth() == CV_8U);
+  assert(src.channels() == 1 || src.channels() == 3);
+  assert(factor >= 1 && factor <= PreviewGenerator::kMaxFactor);
+
+  const int channels = src.channels();
+  const int dst_rows = src.rows / factor;
+  const int dst_cols = src.cols / factor;
+  dst->create(dst_rows, dst_cols, CV_8UC3);
+
+  /* 16 * 16 * 255 still fits into 16 bits */
+  const int row_elems = dst_cols * factor * channels;
+  vector<uint16_t> sums(row_elems);
+
+  const int area = factor * factor;
+  const int half_area = area / 2;
+
+  for (int row = 0; row < dst_rows; ++row) {
+    /* Vertical pass: sum factor source rows elementwise. */
+    std::fill(sums.begin(), sums.end(), 0);
+    for (int i = 0; i < factor; ++i) {
+      const uint8_t *src_row = src.ptr<uint8_t>(row * factor + i);
+      for (int x = 0; x < row_elems; ++x) {
+        sums[x] += src_row[x];
+      }
+    }
+
+    /* Horizontal pass: sum factor pixels, average and swap channels. */
+    uint8_t *dst_row = dst->ptr<uint8_t>(row);
+    if (channels == 3) {
+      for (int col = 0; col < dst_cols; ++col) {
+        const uint16_t *block = &sums[col * factor * 3];
+        int acc[3] = {0, 0, 0};
+        for (int j = 0; j < factor; ++j) {
+          acc[0] += block[3 * j];
+          acc[1] += block[3 * j + 1];
+          acc[2] += block[3 * j + 2];
+        }
+        for (int c = 0; c < 3; ++c) {
+          dst_row[3 * col + c] = (acc[kRgbFromBgr[c]] + half_area) / area;
+        }
+      }
+    } else {
+      for (int col = 0; col < dst_cols; ++col) {
+        const uint16_t *block = &sums[col * factor];
+        int acc = 0;
+        for (int j = 0; j < factor; ++j) {
+          acc += block[j];
+        }
+        const uint8_t value = (acc + half_area) / area;
+        dst_row[3 * col] = value;
+        dst_row[3 * col + 1] = value;
+        dst_row[3 * col + 2] = value;
+      }
+    }
+  }
+}
+
+
+PreviewGenerator::PreviewGenerator(const Parameters &parameters,
+                                   const CameraIndex arity)
+    : parameters_(parameters),
+      previews_(arity) {
+}
+
+double PreviewGenerator::Delay() const {
+  const auto rate = parameters_.Get(Parameters::PREVIEW_RATE);
+  if (rate <= 0) {
+    return 0;
+  }
+
+  const std::chrono::duration<double> elapsed = Clock::now() - last_process_;
+  return std::max(0.0, 1 / rate - elapsed.count());
+}
+
+void PreviewGenerator::Process(const Frameset &frameset) {
+  assert(static_cast<size_t>(frameset.Arity()) == previews_.size());
+
+  last_process_ = Clock::now();
+
+  const auto &params = parameters_.snapshot();
+  if (params.Get(Parameters::PREVIEW_RATE) <= 0) {
+    return;
+  }
+  const int max_width = params.Get(Parameters::PREVIEW_WIDTH);
+
+  for (CameraIndex cam = 0; cam < frameset.Arity(); ++cam) {
+    if (!frameset.IsValid(cam) || !frameset[cam].data.data) {
+      continue;
+    }
+
+    const Mat &data = frameset[cam].data;
+    if (data.depth() != CV_8U ||
+        (data.channels() != 1 && data.channels() != 3)) {
+      ERROR("Unexpected frame type (%i) in cam %i, no preview.",
+            data.type(), cam);
+      continue;
+    }
+
+    /* Smallest factor that fits into preview width */
+    const int factor = std::min(kMaxFactor,
+                                std::max(1, (data.cols + max_width - 1) /
+                                         max_width));
+
+    /* Always a new buffer, previous preview may be still displayed. */
+    Mat preview;
+    DownscaleToRgb(data, factor, &preview);
+    previews_[cam] = preview;
+  }
+}
+
+} // namespace dove_eye
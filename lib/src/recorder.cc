@@ -0,0 +1,320 @@
+#include "dove_eye/recorder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdarg>
+#include <cstring>
+
+#include <opencv2/opencv.hpp>
+
+#include "dove_eye/logging.h"
+
+using std::string;
+using std::vector;
+
+namespace dove_eye {
+
+Recorder::Recorder(const Parameters &parameters, const CameraIndex arity)
+    : parameters_(parameters),
+      arity_(arity),
+      codec_(recording::kRaw),
+      recording_(false),
+      recorded_(0),
+      dropped_(0),
+      files_(arity, nullptr),
+      buffers_(arity),
+      log_file_(nullptr),
+      last_dropped_(arity, kUnknownDropped),
+      has_parameters_(false),
+      stop_requested_(false) {
+}
+
+Recorder::~Recorder() {
+  Stop();
+}
+
+bool Recorder::Start(const std::string &basename,
+                     const recording::Codec codec) {
+  Stop();
+
+  codec_ = codec;
+  recorded_ = 0;
+  dropped_ = 0;
+
+  recording::FileHeader header;
+  std::memcpy(header.magic, recording::kMagic, sizeof(header.magic));
+  header.codec = codec_;
+  header.reserved = 0;
+
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    auto filename = recording::StreamFilename(basename, cam);
+    files_[cam] = fopen(filename.c_str(), "wb");
+    if (!files_[cam]) {
+      ERROR("Cannot open '%s' for recording", filename.c_str());
+      CloseFiles();
+      return false;
+    }
+
+    /* Large buffer makes the writes sequential and big */
+    buffers_[cam].resize(kBufferSize);
+    setvbuf(files_[cam], buffers_[cam].data(), _IOFBF, kBufferSize);
+
+    fwrite(&header, sizeof(header), 1, files_[cam]);
+  }
+
+  auto log_filename = recording::LogFilename(basename);
+  log_file_ = fopen(log_filename.c_str(), "w");
+  if (!log_file_) {
+    ERROR("Cannot open '%s' for recording", log_filename.c_str());
+    CloseFiles();
+    return false;
+  }
+
+  /* Drops are counted from the start of recording */
+  std::fill(last_dropped_.begin(), last_dropped_.end(), kUnknownDropped);
+  has_parameters_ = false;
+  log_.clear();
+  Log("# dove-eye pipeline log");
+  Log("A %i", arity_);
+
+  stop_requested_ = false;
+  writer_ = std::thread(&Recorder::WriteLoop, this);
+  recording_ = true;
+
+  return true;
+}
+
+void Recorder::Stop() {
+  if (!recording_) {
+    return;
+  }
+
+  recording_ = false;
+  {
+    Lock lock(queue_mtx_);
+    stop_requested_ = true;
+    queue_cv_.notify_all();
+  }
+
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+  CloseFiles();
+
+  DEBUG("Recorded %zu framesets, dropped %zu",
+        static_cast<size_t>(recorded_), static_cast<size_t>(dropped_));
+}
+
+void Recorder::Record(const Frameset &frameset) {
+  assert(frameset.Arity() == arity_);
+
+  if (!recording_) {
+    return;
+  }
+
+  LogParameters(frameset.sequence_no);
+
+  /* Timestamps are formatted exactly, replay must see the same values */
+  bool written = false;
+  {
+    Lock lock(queue_mtx_);
+    written = queue_.size() < kQueueSize;
+  }
+
+  string line = "F " + std::to_string(frameset.sequence_no) +
+      (written ? " 1" : " 0");
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    if (frameset.IsValid(cam)) {
+      char timestamp[32];
+      snprintf(timestamp, sizeof(timestamp), " %.17g", frameset[cam].timestamp);
+      line += timestamp;
+    } else {
+      line += " -";
+    }
+  }
+  Log("%s", line.c_str());
+
+  /* Writer only removes from the queue, it can't become full meanwhile */
+  Lock lock(queue_mtx_);
+  if (!written) {
+    dropped_ += 1;
+    return;
+  }
+
+  queue_.push_back(frameset);
+  /* Store capture time, see AggregatorIterator::operator++ */
+  auto &queued = queue_.back();
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    if (queued.IsValid(cam)) {
+      queued[cam].timestamp += parameters_.Get(Parameters::CAM_OFFSET, cam);
+    }
+  }
+
+  queue_cv_.notify_all();
+}
+
+void Recorder::RecordMark(const size_t sequence_no, const CameraIndex cam,
+                          const InnerTracker::Mark &mark,
+                          const bool project_other) {
+  if (!recording_) {
+    return;
+  }
+
+  LogParameters(sequence_no);
+  Log("M %zu %i %i %i %.17g %.17g %.17g %.17g %.17g %.17g %.17g",
+      sequence_no, cam, project_other ? 1 : 0, static_cast<int>(mark.type),
+      mark.center.x, mark.center.y, mark.radius,
+      mark.top_left.x, mark.top_left.y, mark.size.x, mark.size.y);
+}
+
+void Recorder::RecordDropped(const CameraIndex cam, const size_t total) {
+  assert(cam < arity_);
+
+  if (!recording_) {
+    return;
+  }
+
+  /* First call only sets the base */
+  if (last_dropped_[cam] != kUnknownDropped && total > last_dropped_[cam]) {
+    Log("D %i %zu", cam, total - last_dropped_[cam]);
+  }
+  last_dropped_[cam] = total;
+}
+
+void Recorder::Log(const char *format, ...) {
+  char line[1024];
+
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+
+  Lock lock(queue_mtx_);
+  log_ += line;
+  log_ += '\n';
+  queue_cv_.notify_all();
+}
+
+void Recorder::LogParameters(const size_t sequence_no) {
+  const auto &snapshot = parameters_.snapshot();
+  if (has_parameters_ &&
+      snapshot.version() == last_parameters_.version()) {
+    return;
+  }
+
+  for (auto &parameter : parameters_) {
+    const auto value = snapshot.Get(parameter.key);
+    if (!has_parameters_ || value != last_parameters_.Get(parameter.key)) {
+      Log("P %zu %s %.17g", sequence_no, parameter.name.c_str(), value);
+    }
+  }
+
+  last_parameters_ = snapshot;
+  has_parameters_ = true;
+}
+
+void Recorder::WriteLoop() {
+  while (true) {
+    Lock lock(queue_mtx_);
+    queue_cv_.wait(lock, [&] {
+                     return !queue_.empty() || !log_.empty() ||
+                         stop_requested_;
+                   });
+
+    if (!log_.empty()) {
+      string log;
+      log.swap(log_);
+      lock.unlock();
+      fwrite(log.data(), log.size(), 1, log_file_);
+      continue;
+    }
+
+    /* Finish queued framesets even when stopping */
+    if (queue_.empty()) {
+      break;
+    }
+
+    Frameset frameset(std::move(queue_.front()));
+    queue_.pop_front();
+    lock.unlock();
+
+    bool success = true;
+    for (CameraIndex cam = 0; cam < arity_; ++cam) {
+      if (frameset.IsValid(cam)) {
+        success = WriteFrame(cam, frameset[cam]) && success;
+      }
+    }
+
+    if (success) {
+      recorded_ += 1;
+    } else {
+      dropped_ += 1;
+    }
+  }
+
+  for (auto file : files_) {
+    fflush(file);
+  }
+  fflush(log_file_);
+}
+
+bool Recorder::WriteFrame(const CameraIndex cam, const Frame &frame) {
+  FILE *file = files_[cam];
+  const cv::Mat &data = frame.data;
+
+  recording::FrameHeader header;
+  header.timestamp = frame.timestamp;
+  header.rows = data.rows;
+  header.cols = data.cols;
+  header.type = data.type();
+  header.reserved = 0;
+
+  switch (codec_) {
+    case recording::kRaw: {
+      const size_t row_size = data.cols * data.elemSize();
+      header.size = row_size * data.rows;
+
+      bool result = fwrite(&header, sizeof(header), 1, file) == 1;
+      if (data.isContinuous()) {
+        result = result && fwrite(data.data, header.size, 1, file) == 1;
+      } else {
+        for (int row = 0; row < data.rows; ++row) {
+          result = result && fwrite(data.ptr(row), row_size, 1, file) == 1;
+        }
+      }
+      return result;
+    }
+
+    case recording::kPng: {
+      /* Lowest compression level is still lossless, just faster */
+      vector<uchar> encoded;
+      vector<int> params = {CV_IMWRITE_PNG_COMPRESSION, 1};
+      if (!cv::imencode(".png", data, encoded, params)) {
+        return false;
+      }
+      header.size = encoded.size();
+
+      return fwrite(&header, sizeof(header), 1, file) == 1 &&
+          fwrite(encoded.data(), encoded.size(), 1, file) == 1;
+    }
+  }
+
+  assert(false);
+  return false;
+}
+
+void Recorder::CloseFiles() {
+  for (auto &file : files_) {
+    if (file) {
+      fclose(file);
+      file = nullptr;
+    }
+  }
+
+  if (log_file_) {
+    fclose(log_file_);
+    log_file_ = nullptr;
+  }
+}
+
+} // namespace dove_eye
@@ -0,0 +1,127 @@
+#include "dove_eye/recording_video_provider.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "dove_eye/logging.h"
+#include "dove_eye/recording_format.h"
+
+namespace {
+
+bool ReadFileHeader(FILE *file, dove_eye::recording::FileHeader *header) {
+  return fread(header, sizeof(*header), 1, file) == 1 &&
+      std::memcmp(header->magic, dove_eye::recording::kMagic,
+                  sizeof(header->magic)) == 0;
+}
+
+} // anonymous namespace
+
+namespace dove_eye {
+
+class RecordingFrameIterator : public FrameIteratorImpl {
+ public:
+  explicit RecordingFrameIterator(const std::string &filename)
+      : file_(fopen(filename.c_str(), "rb")),
+        valid_(false) {
+    frame_.timestamp = 0;
+
+    recording::FileHeader header;
+    if (!file_ || !ReadFileHeader(file_, &header)) {
+      ERROR("'%s' is not a recording", filename.c_str());
+      return;
+    }
+
+    codec_ = static_cast<recording::Codec>(header.codec);
+    valid_ = true;
+    MoveNext();
+  }
+
+  ~RecordingFrameIterator() override {
+    if (file_) {
+      fclose(file_);
+    }
+  }
+
+  /** Each frame is read into a new buffer, no need to copy */
+  inline Frame GetFrame() const override {
+    return frame_;
+  }
+
+  void MoveNext() override {
+    recording::FrameHeader header;
+    valid_ = valid_ && fread(&header, sizeof(header), 1, file_) == 1;
+    if (!valid_) {
+      return;
+    }
+
+    frame_.timestamp = header.timestamp;
+
+    switch (codec_) {
+      case recording::kRaw: {
+        cv::Mat data(header.rows, header.cols, header.type);
+        valid_ = data.total() * data.elemSize() == header.size &&
+            fread(data.data, header.size, 1, file_) == 1;
+        frame_.data = data;
+        break;
+      }
+
+      case recording::kPng: {
+        std::vector<uchar> encoded(header.size);
+        valid_ = fread(encoded.data(), encoded.size(), 1, file_) == 1;
+        if (valid_) {
+          frame_.data = cv::imdecode(encoded, CV_LOAD_IMAGE_UNCHANGED);
+          valid_ = !frame_.data.empty();
+        }
+        break;
+      }
+
+      default:
+        ERROR("Unknown recording codec %u", static_cast<unsigned>(codec_));
+        valid_ = false;
+        break;
+    }
+  }
+
+  inline bool IsValid() override {
+    return valid_;
+  }
+
+ private:
+  FILE *file_;
+  recording::Codec codec_;
+  bool valid_;
+  Frame frame_;
+};
+
+
+/* Provider */
+RecordingVideoProvider::RecordingVideoProvider(const std::string &filename)
+    : VideoProvider(),
+      filename_(filename) {
+}
+
+FrameIterator RecordingVideoProvider::begin() {
+  return FrameIterator(this, new RecordingFrameIterator(filename_));
+}
+
+FrameIterator RecordingVideoProvider::end() {
+  return FrameIterator(this);
+}
+
+bool RecordingVideoProvider::IsRecording(const std::string &filename) {
+  FILE *file = fopen(filename.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+
+  recording::FileHeader header;
+  bool result = ReadFileHeader(file, &header);
+  fclose(file);
+
+  return result;
+}
+
+} // namespace dove_eye
@@ -1,9 +1,35 @@
 #include "dove_eye/searching_tracker.h"
 
+#include <algorithm>
+#include <cmath>
 
 #include "dove_eye/cv_logging.h"
 #include "dove_eye/logging.h"
 
+namespace {
+
+/** Enlarge object rectangle by margin on each side
+ *
+ * Size of the result is clamped to [min_factor, max_factor] multiples of the
+ * object size, center is kept.
+ */
+cv::Rect UncertaintyRoi(const cv::Rect &object, const dove_eye::Point2 margin,
+                        const double min_factor, const double max_factor) {
+  const double width = std::min(max_factor * object.width,
+                                std::max(min_factor * object.width,
+                                         object.width + 2.0 * margin.x));
+  const double height = std::min(max_factor * object.height,
+                                 std::max(min_factor * object.height,
+                                          object.height + 2.0 * margin.y));
+
+  const double center_x = object.x + 0.5 * object.width;
+  const double center_y = object.y + 0.5 * object.height;
+  return cv::Rect(center_x - 0.5 * width, center_y - 0.5 * height,
+                  width, height);
+}
+
+} // anonymous namespace
+
 namespace dove_eye {
 
 bool SearchingTracker::InitializeTracking(const Frame &frame, const Mark mark,
@@ -28,13 +54,14 @@ bool SearchingTracker::InitializeTracking(
     Posit *result) {
 
   // FIXME Possibly use diffent parameters to specify epiline mask
-  auto thickness = parameters().Get(Parameters::TEMPLATE_RADIUS) *
-      parameters().Get(Parameters::SEARCH_FACTOR);
+  const auto &params = parameters().snapshot();
+  auto thickness = params.Get(Parameters::TEMPLATE_RADIUS) *
+      params.Get(Parameters::SEARCH_FACTOR);
 
   const auto epiline_mask = EpilineToMask(frame.data.size(), thickness, epiline);
 
   // FIXME Use different threshold for foreign search data?
-  const auto thr = parameters().Get(Parameters::SEARCH_THRESHOLD);
+  const auto thr = params.Get(Parameters::SEARCH_THRESHOLD);
 
   Mark match_mark(Mark::kInvalid);
   // TODO Remove non-const cast! Do it properly when projection is working
@@ -60,42 +87,92 @@ bool SearchingTracker::InitializeTracking(
 bool SearchingTracker::Track(const Frame &frame, Posit *result) {
   assert(initialized());
 
-  const auto f = parameters().Get(Parameters::SEARCH_FACTOR);
-  const auto thr = parameters().Get(Parameters::SEARCH_THRESHOLD);
   const auto min_speed = parameters().Get(Parameters::SEARCH_MIN_SPEED);
 
   /* Calculate expected position */
   auto expected = kalman_filter().Predict(frame.timestamp);
   auto velocity = kalman_filter().PredictChange(frame.timestamp);
-  const auto roi = DataToRoi(tracker_data(), expected, f);
+  auto deviation = kalman_filter().PredictDeviation(frame.timestamp);
+
+  /*
+   * Constant velocity model doesn't know maneuvers (bounces, hits), their
+   * error is comparable to the displacement per frame. Filter deviation
+   * alone settles at about the observation noise for any speed.
+   */
+  deviation = Point2(std::hypot(deviation.x, velocity.x),
+                     std::hypot(deviation.y, velocity.y));
+
   bool moving = (cv::norm(velocity) > min_speed);
   // TODO temporarily disable motion detection
   moving = false;
 
-  DEBUG("%p->%s, expected: [%f, %f], velocity [%f, %f], moving: %i",
+  DEBUG("%p->%s, expected: [%f, %f], velocity [%f, %f], deviation [%f, %f], "
+        "moving: %i",
         this, __func__,
         expected.x, expected.y,
         velocity.x, velocity.y,
+        deviation.x, deviation.y,
         moving);
 
   /* Filter movement */
-  cv::Mat fg_mask;
-  // TODO background subtraction
-
-  auto fg_mask_ptr = moving ? &fg_mask : nullptr;
+  // TODO background subtraction (when moving)
 
   /* Search for object */
-  Mark match_mark(Mark::kInvalid);
-  if (!Search(frame.data, tracker_data(), &roi, fg_mask_ptr, thr, &match_mark)) {
+  Posit posit;
+  if (!SearchAround(frame, expected, deviation, &posit)) {
     return false;
   }
 
   /* Use result */
-  const auto posit = MarkToPosit(match_mark);
   *result = kalman_filter().Update(frame.timestamp, posit);
   return true;
 }
 
+bool SearchingTracker::Track(const Frame &frame,
+                             const Point2 expected,
+                             const Point2 deviation,
+                             Posit *result) {
+  assert(initialized());
+
+  /* Keep own filter running, it's used when the external prediction stops */
+  (void)kalman_filter().Predict(frame.timestamp);
+
+  Posit posit;
+  if (!SearchAround(frame, expected, deviation, &posit)) {
+    return false;
+  }
+
+  (void)kalman_filter().Update(frame.timestamp, posit);
+
+  /* Raw match, smoothing is up to the caller's filter */
+  *result = posit;
+  return true;
+}
+
+bool SearchingTracker::Predict(const Frame &frame, Posit *result) {
+  assert(initialized());
+
+  *result = kalman_filter().Coast(frame.timestamp);
+  return true;
+}
+
+void SearchingTracker::Observe(const Frame &frame, const Posit posit) {
+  assert(initialized());
+
+  (void)kalman_filter().Predict(frame.timestamp);
+  (void)kalman_filter().Update(frame.timestamp, posit);
+}
+
+bool SearchingTracker::ObjectSize(Point2 *size) const {
+  if (!initialized()) {
+    return false;
+  }
+
+  const auto extent = DataToRoi(tracker_data(), Point2(), 1);
+  *size = Point2(extent.width, extent.height);
+  return extent.area() > 0;
+}
+
 bool SearchingTracker::ReinitializeTracking(const Frame &frame, Posit *result) {
   assert(initialized());
 
@@ -116,9 +193,38 @@ bool SearchingTracker::ReinitializeTracking(const Frame &frame, Posit *result) {
   return true;
 }
 
+bool SearchingTracker::SearchAround(const Frame &frame,
+                                    const Point2 expected,
+                                    const Point2 deviation,
+                                    Posit *result) {
+  const auto &params = parameters().snapshot();
+  const auto max_f = params.Get(Parameters::SEARCH_FACTOR);
+  const auto min_f = params.Get(Parameters::SEARCH_MIN_FACTOR);
+  const auto sigma = params.Get(Parameters::SEARCH_SIGMA);
+  const auto thr = params.Get(Parameters::SEARCH_THRESHOLD);
+
+  /*
+   * Object extent around expected position enlarged by uncertainty of the
+   * prediction (sigma-multiple of deviation on each side), certain
+   * predictions thus get small search windows.
+   */
+  const auto roi = UncertaintyRoi(DataToRoi(tracker_data(), expected, 1),
+                                  sigma * deviation, min_f, max_f);
+
+  Mark match_mark(Mark::kInvalid);
+  if (!Search(frame.data, tracker_data(), &roi, nullptr, thr, &match_mark)) {
+    return false;
+  }
+
+  UpdateTrackerData(frame.data, match_mark);
+  *result = MarkToPosit(match_mark);
+  return true;
+}
+
 void SearchingTracker::InitializeKalmanFilter() {
-  const auto process_var = parameters().Get(Parameters::SEARCH_KF_PROC_V);
-  const auto observation_var = parameters().Get(Parameters::SEARCH_KF_OBS_V);
+  const auto &params = parameters().snapshot();
+  const auto process_var = params.Get(Parameters::SEARCH_KF_PROC_V);
+  const auto observation_var = params.Get(Parameters::SEARCH_KF_OBS_V);
 
   kalman_filter().Init(process_var, observation_var);
 }
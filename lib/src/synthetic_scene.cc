@@ -0,0 +1,277 @@
+#include "dove_eye/synthetic_scene.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "dove_eye/camera_pair.h"
+
+using cv::Mat;
+using cv::Mat_;
+
+namespace {
+
+/** Drawing functions take fixed point coordinates with this many bits */
+const int kShift = 4;
+
+inline cv::Point FixedPoint(const double x, const double y) {
+  return cv::Point(std::lround(x * (1 << kShift)),
+                   std::lround(y * (1 << kShift)));
+}
+
+/** Seed of RNG for given frame (splitmix64 finalizer) */
+uint64_t FrameSeed(const uint64_t seed, const dove_eye::CameraIndex cam,
+                   const uint64_t frame_no) {
+  uint64_t z = seed + 0x9e3779b97f4a7c15ULL * (1 + cam + (frame_no << 8));
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+Mat CrossProductMatrix(const Mat &v) {
+  const double x = v.at<double>(0);
+  const double y = v.at<double>(1);
+  const double z = v.at<double>(2);
+  return (Mat_<double>(3, 3) <<
+          0, -z,  y,
+          z,  0, -x,
+         -y,  x,  0);
+}
+
+} // anonymous namespace
+
+namespace dove_eye {
+
+SyntheticScene::SyntheticScene(const CalibrationData &calibration_data,
+                               const Trajectory &trajectory,
+                               const Settings &settings,
+                               const OcclusionVector &occlusions)
+    : calibration_data_(calibration_data),
+      trajectory_(trajectory),
+      settings_(settings),
+      occlusions_(occlusions),
+      frame_count_(0) {
+  assert(settings_.fps > 0);
+
+  /* Globals are calculated lazily, do it before providers render in threads */
+  if (Arity() > 0) {
+    (void)calibration_data_.ProjectionMatrix(0);
+  }
+
+  if (!trajectory_.empty()) {
+    /* Frames whose timestamp is within the trajectory */
+    frame_count_ = std::floor(trajectory_.back().time * settings_.fps + 1e-6);
+  }
+}
+
+CalibrationData SyntheticScene::CreateRig(const CameraIndex arity,
+                                          const int width, const int height,
+                                          const double fov,
+                                          const double distance,
+                                          const double angle) {
+  CalibrationData result(arity);
+
+  const double f = 0.5 * width / std::tan(0.5 * fov);
+  const Mat camera_matrix = (Mat_<double>(3, 3) <<
+                             f, 0, 0.5 * width,
+                             0, f, 0.5 * height,
+                             0, 0, 1);
+
+  /* World-to-camera transformations, world is camera 0 */
+  std::vector<Mat> rotations(arity);
+  std::vector<Mat> translations(arity);
+  const Mat target = (Mat_<double>(3, 1) << 0, 0, distance);
+  const Mat backward = (Mat_<double>(3, 1) << 0, 0, -distance);
+
+  for (CameraIndex cam = 0; cam < arity; ++cam) {
+    const double a = cam * angle;
+    const Mat orbit = (Mat_<double>(3, 3) <<
+                       std::cos(a),  0, std::sin(a),
+                       0,            1, 0,
+                       -std::sin(a), 0, std::cos(a));
+    const Mat center = target + orbit * backward;
+
+    rotations[cam] = orbit.t();
+    translations[cam] = -rotations[cam] * center;
+
+    auto &parameters = result.camera_parameters_[cam];
+    parameters.camera_matrix = camera_matrix.clone();
+    parameters.distortion_coefficients = Mat::zeros(5, 1, CV_64F);
+  }
+
+  /* Pair parameters as stereoCalibrate would give them */
+  const Mat camera_matrix_inv = camera_matrix.inv();
+  for (auto pair : CameraPair::GenerateArray(arity)) {
+    const auto &R1 = rotations[pair.cam1];
+    const auto &R2 = rotations[pair.cam2];
+
+    Mat R = R2 * R1.t();
+    Mat T = translations[pair.cam2] - R * translations[pair.cam1];
+    Mat F = camera_matrix_inv.t() * CrossProductMatrix(T) * R *
+        camera_matrix_inv;
+    if (std::abs(F.at<double>(2, 2)) > 1e-12) {
+      F /= F.at<double>(2, 2);
+    }
+
+    auto &parameters = result.pair_parameters_[pair.index];
+    parameters.rotation = R;
+    parameters.translation = T;
+    parameters.fundamental_matrix = F;
+  }
+
+  return result;
+}
+
+Location SyntheticScene::LocationAt(const Frame::Timestamp time) const {
+  if (trajectory_.empty()) {
+    return Location();
+  }
+
+  auto next = std::upper_bound(trajectory_.begin(), trajectory_.end(), time,
+                               [](const Frame::Timestamp t, const Waypoint &w) {
+                                 return t < w.time;
+                               });
+  if (next == trajectory_.begin()) {
+    return trajectory_.front().location;
+  }
+  if (next == trajectory_.end()) {
+    return trajectory_.back().location;
+  }
+
+  const auto &previous = *(next - 1);
+  const double span = next->time - previous.time;
+  const float alpha = (span > 0) ? (time - previous.time) / span : 0;
+
+  return previous.location + alpha * (next->location - previous.location);
+}
+
+bool SyntheticScene::PositAt(const CameraIndex cam,
+                             const Frame::Timestamp time,
+                             Posit *result) const {
+  double radius;
+  return PositAt(cam, time, result, &radius);
+}
+
+bool SyntheticScene::PositAt(const CameraIndex cam,
+                             const Frame::Timestamp time,
+                             Posit *result, double *radius) const {
+  if (!Project(cam, LocationAt(time), result, radius)) {
+    return false;
+  }
+
+  const bool inside = result->x >= 0 && result->x < settings_.width &&
+      result->y >= 0 && result->y < settings_.height;
+
+  return inside && !IsOccluded(cam, time);
+}
+
+Positset SyntheticScene::PositsetAt(const Frame::Timestamp time) const {
+  Positset result(Arity());
+  for (CameraIndex cam = 0; cam < Arity(); ++cam) {
+    result.SetValid(cam, PositAt(cam, time, &result[cam]));
+  }
+
+  return result;
+}
+
+void SyntheticScene::Render(const CameraIndex cam, const size_t frame_no,
+                            const Mat &background, Mat *result,
+                            Mat *noise) const {
+  background.copyTo(*result);
+
+  const auto time = FrameTimestamp(frame_no);
+  Posit posit;
+  double radius;
+  if (!IsOccluded(cam, time) &&
+      Project(cam, LocationAt(time), &posit, &radius)) {
+    const auto &color = settings_.object_color;
+
+    switch (settings_.object_type) {
+      case kBall: {
+        const auto highlight = 0.5 * color + cv::Scalar::all(127);
+        cv::circle(*result, FixedPoint(posit.x, posit.y),
+                   std::lround(radius * (1 << kShift)),
+                   color, -1, CV_AA, kShift);
+        cv::circle(*result,
+                   FixedPoint(posit.x - radius / 3, posit.y - radius / 3),
+                   std::lround(radius / 3 * (1 << kShift)),
+                   highlight, -1, CV_AA, kShift);
+        break;
+      }
+
+      case kPatch: {
+        /* 4x4 checkerboard */
+        const int squares = 4;
+        const double side = 2 * radius / squares;
+        for (int row = 0; row < squares; ++row) {
+          for (int col = 0; col < squares; ++col) {
+            const double x = posit.x - radius + col * side;
+            const double y = posit.y - radius + row * side;
+            const auto square_color = ((row + col) % 2) ?
+                color : cv::Scalar::all(255);
+            cv::rectangle(*result, FixedPoint(x, y),
+                          FixedPoint(x + side, y + side),
+                          square_color, -1, CV_AA, kShift);
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  if (settings_.noise > 0) {
+    cv::RNG rng(FrameSeed(settings_.seed, cam, frame_no));
+    noise->create(result->size(), CV_16SC(result->channels()));
+    rng.fill(*noise, cv::RNG::NORMAL, 0, settings_.noise);
+    cv::add(*result, *noise, *result, cv::noArray(), result->type());
+  }
+}
+
+Mat SyntheticScene::Background(const CameraIndex cam) const {
+  /* Frame numbers are far from the top of the range */
+  cv::RNG rng(FrameSeed(settings_.seed, cam, ~0ULL >> 8));
+
+  Mat coarse(settings_.height / 16 + 1, settings_.width / 16 + 1, CV_8UC3);
+  rng.fill(coarse, cv::RNG::UNIFORM, 64, 192);
+
+  Mat result;
+  cv::resize(coarse, result, cv::Size(settings_.width, settings_.height), 0, 0,
+             cv::INTER_CUBIC);
+
+  return result;
+}
+
+bool SyntheticScene::Project(const CameraIndex cam, const Location location,
+                             Posit *posit, double *radius) const {
+  const auto &P = calibration_data_.ProjectionMatrix(cam);
+  const Mat point = (Mat_<double>(4, 1) <<
+                     location.x, location.y, location.z, 1);
+  const Mat image_point = P * point;
+
+  /* Last row of camera matrix is (0, 0, 1), w is depth */
+  const double w = image_point.at<double>(2);
+  if (w <= 0) {
+    return false;
+  }
+
+  *posit = Posit(image_point.at<double>(0) / w, image_point.at<double>(1) / w);
+
+  const auto &C = calibration_data_.camera_parameters(cam).camera_matrix;
+  *radius = C.at<double>(0, 0) * settings_.object_size / w;
+
+  return true;
+}
+
+bool SyntheticScene::IsOccluded(const CameraIndex cam,
+                                const Frame::Timestamp time) const {
+  for (auto &occlusion : occlusions_) {
+    if (occlusion.cam == cam &&
+        occlusion.begin <= time && time < occlusion.end) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+} // namespace dove_eye
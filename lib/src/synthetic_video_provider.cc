@@ -0,0 +1,134 @@
+#include "dove_eye/synthetic_video_provider.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "dove_eye/frame_iterator.h"
+
+namespace {
+
+/** Whether anybody else than the pool refers to the buffer
+ *
+ * Consumers release their references in other threads, counter is read
+ * atomically (as cv::Mat changes it).
+ */
+inline bool IsShared(const cv::Mat &mat) {
+#if CV_MAJOR_VERSION < 3
+  return mat.refcount && CV_XADD(mat.refcount, 0) > 1;
+#else
+  return mat.u && CV_XADD(&mat.u->refcount, 0) > 1;
+#endif
+}
+
+} // anonymous namespace
+
+namespace dove_eye {
+
+class SyntheticFrameIterator : public FrameIteratorImpl {
+ public:
+  SyntheticFrameIterator(const SyntheticVideoProvider::ScenePtr scene,
+                         const CameraIndex cam,
+                         const size_t frame_no)
+      : scene_(scene),
+        cam_(cam),
+        frame_no_(frame_no),
+        background_(scene_->Background(cam_)) {
+    Render();
+  }
+
+  /**
+   * Frame data are in pooled buffer that is not reused while referenced, so
+   * no copy is needed.
+   */
+  inline Frame GetFrame() const override {
+    return frame_;
+  }
+
+  inline void MoveNext() override {
+    ++frame_no_;
+    Render();
+  }
+
+  inline bool IsValid() override {
+    return frame_no_ < scene_->FrameCount();
+  }
+
+ private:
+  static const size_t kMaxPoolSize = 32;
+
+  const SyntheticVideoProvider::ScenePtr scene_;
+  const CameraIndex cam_;
+  size_t frame_no_;
+
+  const cv::Mat background_;
+  cv::Mat noise_;
+  std::vector<cv::Mat> pool_;
+
+  Frame frame_;
+
+  void Render() {
+    if (!IsValid()) {
+      return;
+    }
+
+    cv::Mat buffer = PoolBuffer();
+    scene_->Render(cam_, frame_no_, background_, &buffer, &noise_);
+
+    frame_.timestamp = scene_->FrameTimestamp(frame_no_);
+    frame_.data = buffer;
+  }
+
+  cv::Mat PoolBuffer() {
+    for (auto &buffer : pool_) {
+      if (!IsShared(buffer)) {
+        return buffer;
+      }
+    }
+
+    if (pool_.size() < kMaxPoolSize) {
+      pool_.push_back(background_.clone());
+      return pool_.back();
+    }
+
+    /* Consumers hold all pooled buffers, don't wait for them. */
+    return cv::Mat();
+  }
+};
+
+
+/* Provider */
+SyntheticVideoProvider::SyntheticVideoProvider(const ScenePtr scene,
+                                               const CameraIndex cam)
+    : VideoProvider(),
+      scene_(scene),
+      cam_(cam) {
+  assert(cam_ < scene_->Arity());
+}
+
+FrameIterator SyntheticVideoProvider::begin() {
+  return FrameIterator(this, new SyntheticFrameIterator(scene_, cam_, 0));
+}
+
+FrameIterator SyntheticVideoProvider::end() {
+  return FrameIterator(this);
+}
+
+FrameIterator SyntheticVideoProvider::Seek(const Frame::Timestamp timestamp) {
+  /* Inverse of SyntheticScene::FrameTimestamp, rounded up */
+  const auto frame_position =
+      std::ceil(timestamp * scene_->settings().fps - 1 - 1e-6);
+  const size_t frame_no =
+      (frame_position > 0) ? static_cast<size_t>(frame_position) : 0;
+
+  if (frame_no >= scene_->FrameCount()) {
+    return end();
+  }
+
+  return FrameIterator(this,
+                       new SyntheticFrameIterator(scene_, cam_, frame_no));
+}
+
+} // namespace dove_eye
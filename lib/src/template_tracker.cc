@@ -1,5 +1,7 @@
 #include "dove_eye/template_tracker.h"
 
+#include <algorithm>
+
 #include <opencv2/opencv.hpp>
 
 #include "config.h"
@@ -7,9 +9,26 @@
 #include "dove_eye/logging.h"
 
 using cv::matchTemplate;
-using cv::meanStdDev;
 using cv::minMaxLoc;
 
+namespace {
+
+bool CropTemplate(const cv::Mat &data, const dove_eye::Point2 point,
+                  const double radius, cv::Mat *result) {
+  if (point.x < radius || point.x >= data.cols - radius ||
+      point.y < radius || point.y >= data.rows - radius) {
+    return false;
+  }
+
+  cv::Rect roi(point.x - radius, point.y - radius, 2 * radius, 2 * radius);
+
+  /* We don't want to have the template overwritten */
+  *result = data(roi).clone();
+  return true;
+}
+
+} // anonymous namespace
+
 namespace dove_eye {
 
 bool TemplateTracker::InitTrackerData(const cv::Mat &data, const Mark &mark) {
@@ -18,24 +37,28 @@ bool TemplateTracker::InitTrackerData(const cv::Mat &data, const Mark &mark) {
         mark.radius,
         mark.center.x, mark.center.y);
 
-  const auto point = mark.center;
-  const auto radius = mark.radius;
-
-  if (point.x < radius || point.x >= data.cols - radius ||
-      point.y < radius || point.y >= data.rows - radius) {
+  cv::Mat search_template;
+  if (!CropTemplate(data, mark.center, mark.radius, &search_template)) {
     return false;
   }
 
-  cv::Rect roi(point.x - radius, point.y - radius, 2 * radius, 2 * radius);
-
-  /* We don't want to have the template overwritten */
-  data_.search_template = data(roi).clone();
-  data_.radius = radius;
+  /* New object, forget the old model */
+  data_.templates.assign(1, search_template);
+  data_.next = 1;
+  data_.best = 0;
+  data_.best_value = 0;
+  data_.radius = mark.radius;
 
   return true;
 }
 
 /** Wrapper for OpenCV function matchTemplate
+ *
+ * All templates of the model are matched against the same ROI, promoted one
+ * first.
+ *
+ * @note When tracker_data is not own (epiline initialization), only its
+ *       best/best_value are changed, they're overwritten before own use.
  * @see SearchingTracker::Search()
  */
 bool TemplateTracker::Search(
@@ -45,7 +68,8 @@ bool TemplateTracker::Search(
       const cv::Mat *mask,
       const double threshold,
       Mark *result) const {
-  const TemplateData &tpl = static_cast<const TemplateData &>(tracker_data);
+  TemplateData &tpl = static_cast<TemplateData &>(tracker_data);
+  assert(!tpl.templates.empty());
 
   DEBUG("%p->%s([%i, %i], %f, %p[%i, %i]@[%i, %i], %p, %f, res)",
         this, __func__,
@@ -63,27 +87,12 @@ bool TemplateTracker::Search(
     extended_roi &= cv::Rect(cv::Point(0, 0), data.size());
   }
 
-  if (extended_roi.width < tpl.search_template.cols ||
-      extended_roi.height < tpl.search_template.rows) {
+  if (extended_roi.width < tpl.templates.front().cols ||
+      extended_roi.height < tpl.templates.front().rows) {
     DEBUG("%p->%s small-roi", this, __func__);
     return false;
   }
 
-  /* Experimentally CV_TM_CCOEFF_NORMED gave best results */
-  //const int method = CV_TM_SQDIFF_NORMED;
-  //const int method = CV_TM_CCORR_NORMED
-  const int method = CV_TM_CCOEFF_NORMED;
-
-  cv::Mat match_result;
-  matchTemplate(data(extended_roi), tpl.search_template, match_result, method);
-
-
-  double min_val;
-  cv::Point min_loc;
-  double max_val;
-  cv::Point max_loc;
-  cv::Scalar std_dev;
-
   cv::Mat shifted_mask;
   if (mask) {
     /* Mask is first cropped with same ROI as image */
@@ -99,41 +108,50 @@ bool TemplateTracker::Search(
     shift_rect.height += 1;
 
     shifted_mask = cropped_mask(shift_rect);
-
-    assert(match_result.rows == shifted_mask.rows);
-    assert(match_result.cols == shifted_mask.cols);
-
-    minMaxLoc(match_result, &min_val, &max_val, &min_loc, &max_loc, shifted_mask);
-    meanStdDev(match_result, cv::noArray(), std_dev, shifted_mask);
-  } else {
-    minMaxLoc(match_result, &min_val, &max_val, &min_loc, &max_loc);
-    meanStdDev(match_result, cv::noArray(), std_dev);
   }
 
-  const double value = (method == CV_TM_SQDIFF_NORMED) ? (1-min_val) :
-      (method == CV_TM_CCORR_NORMED) ? max_val :
-      (method == CV_TM_CCOEFF_NORMED) ? (max_val - min_val) : 0;
-
-#ifdef CONFIG_DEBUG_HIGHGUI
-  cv::Mat to_show;
-  if (mask) {
-    cv::Mat masked;
-    match_result.copyTo(masked, shifted_mask);
+  const auto confident = parameters().Get(Parameters::TEMPLATE_UPDATE);
+  const auto image = data(extended_roi);
+  const auto count = tpl.templates.size();
+  if (tpl.best >= count) {
+    tpl.best = 0;
+  }
 
-    to_show = (masked - min_val) / value;
-    log_mat((reinterpret_cast<size_t>(this) * 100) + 10, to_show);
-  } else {
-    to_show = (match_result - min_val) / value;
-    log_mat((reinterpret_cast<size_t>(this) * 100) + 10, to_show);
+  /* Result buffer is shared by all templates (same size) */
+  cv::Mat match_result;
+  double value = -1;
+  double correlation = -1;
+  cv::Point loc;
+  size_t best = tpl.best;
+  for (size_t i = 0; i < count; ++i) {
+    /* Promoted template first, then the others in order */
+    const size_t index = (i == 0) ? tpl.best : (i - 1 < tpl.best) ? i - 1 : i;
+
+    cv::Point template_loc;
+    double template_correlation;
+    const double template_value = MatchTemplate(
+        image, tpl.templates[index], mask ? &shifted_mask : nullptr,
+        &match_result, &template_loc, &template_correlation);
+
+    if (template_value > value) {
+      value = template_value;
+      correlation = template_correlation;
+      loc = template_loc;
+      best = index;
+    }
+
+    if (correlation >= confident) {
+      break;
+    }
   }
-#endif
 
+  tpl.best = best;
+  tpl.best_value = correlation;
 
   if (value <= threshold) {
 #ifdef CONFIG_DEBUG_HIGHGUI
-    log_mat(reinterpret_cast<size_t>(this) * 100 + 1, data(extended_roi).clone());
-    log_mat(reinterpret_cast<size_t>(this) * 100 + 2, tpl.search_template);
-    log_mat(reinterpret_cast<size_t>(this) * 100 + 2, to_show.clone());
+    log_mat(reinterpret_cast<size_t>(this) * 100 + 1, image.clone());
+    log_mat(reinterpret_cast<size_t>(this) * 100 + 2, tpl.templates[best]);
 #endif
     DEBUG("%p->%s low value (%f/%f)", this, __func__, value, threshold);
     return false;
@@ -141,10 +159,6 @@ bool TemplateTracker::Search(
 
   // TODO return false also when minumum is shallow (i.e. not unique match)
 
-  const auto loc = (method == CV_TM_SQDIFF_NORMED) ? min_loc :
-      (method == CV_TM_CCORR_NORMED) ? max_loc :
-      (method == CV_TM_CCOEFF_NORMED) ? (max_loc) : cv::Point();
-
   /* Transform coordinates of found matchpoint to whole image */
   cv::Point tpl_offset = -tpl.TopLeft(cv::Point(0, 0));
   auto match_point = Point2(loc.x, loc.y) + Point2(tpl_offset.x, tpl_offset.y);
@@ -154,9 +168,99 @@ bool TemplateTracker::Search(
   result->center = match_point;
   result->radius = tpl.radius;
 
-  DEBUG("%p->%s matched (%f/%f)", this, __func__, value, threshold);
+  DEBUG("%p->%s matched (%f/%f) template %zu/%zu", this, __func__,
+        value, threshold, best, count);
   return true;
 }
 
+void TemplateTracker::UpdateTrackerData(const cv::Mat &data,
+                                        const Mark &match) {
+  const auto &params = parameters().snapshot();
+  const size_t count = params.Get(Parameters::TEMPLATE_COUNT);
+
+  /* Parameter may have changed, keep the initial template */
+  if (data_.templates.size() > std::max<size_t>(count, 1)) {
+    data_.templates.resize(std::max<size_t>(count, 1));
+  }
+  if (data_.best >= data_.templates.size()) {
+    data_.best = 0;
+  }
+  if (data_.next >= count) {
+    data_.next = 1;
+  }
+
+  /* Only confident matches enter the model, otherwise it'd drift */
+  if (count < 2 || data_.best_value < params.Get(Parameters::TEMPLATE_UPDATE)) {
+    return;
+  }
+
+  cv::Mat search_template;
+  if (!CropTemplate(data, match.center, data_.radius, &search_template)) {
+    return;
+  }
+
+  if (data_.templates.size() < count) {
+    data_.templates.push_back(search_template);
+  } else {
+    /* Overwrite the oldest of the ring */
+    data_.templates[data_.next] = search_template;
+    data_.next = (data_.next + 1 < count) ? data_.next + 1 : 1;
+  }
+}
+
+double TemplateTracker::MatchTemplate(const cv::Mat &data,
+                                      const cv::Mat &search_template,
+                                      const cv::Mat *shifted_mask,
+                                      cv::Mat *match_result,
+                                      cv::Point *loc,
+                                      double *correlation) const {
+  /* Experimentally CV_TM_CCOEFF_NORMED gave best results */
+  //const int method = CV_TM_SQDIFF_NORMED;
+  //const int method = CV_TM_CCORR_NORMED
+  const int method = CV_TM_CCOEFF_NORMED;
+
+  matchTemplate(data, search_template, *match_result, method);
+
+  double min_val;
+  cv::Point min_loc;
+  double max_val;
+  cv::Point max_loc;
+
+  if (shifted_mask) {
+    assert(match_result->rows == shifted_mask->rows);
+    assert(match_result->cols == shifted_mask->cols);
+
+    minMaxLoc(*match_result, &min_val, &max_val, &min_loc, &max_loc,
+              *shifted_mask);
+  } else {
+    minMaxLoc(*match_result, &min_val, &max_val, &min_loc, &max_loc);
+  }
+
+  const double value = (method == CV_TM_SQDIFF_NORMED) ? (1-min_val) :
+      (method == CV_TM_CCORR_NORMED) ? max_val :
+      (method == CV_TM_CCOEFF_NORMED) ? (max_val - min_val) : 0;
+
+#ifdef CONFIG_DEBUG_HIGHGUI
+  cv::Mat to_show;
+  if (shifted_mask) {
+    cv::Mat masked;
+    match_result->copyTo(masked, *shifted_mask);
+    to_show = (masked - min_val) / value;
+  } else {
+    to_show = (*match_result - min_val) / value;
+  }
+  log_mat((reinterpret_cast<size_t>(this) * 100) + 10, to_show);
+#endif
+
+  /* Value is relative to the worst location, model confidence is not */
+  *correlation = (method == CV_TM_SQDIFF_NORMED) ? (1-min_val) : max_val;
+
+  *loc = (method == CV_TM_SQDIFF_NORMED) ? min_loc :
+      (method == CV_TM_CCORR_NORMED) ? max_loc :
+      (method == CV_TM_CCOEFF_NORMED) ? (max_loc) : cv::Point();
+
+  return value;
+}
+
 
 } // namespace dove_eye
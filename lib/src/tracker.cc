@@ -1,6 +1,8 @@
 #include "dove_eye/tracker.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <utility>
 
 #include <opencv2/opencv.hpp>
@@ -14,25 +16,96 @@ using cv::undistortPoints;
 
 namespace dove_eye {
 
-Tracker::Tracker(const CameraIndex arity, const InnerTracker &inner_tracker)
-    : arity_(arity),
+Tracker::Tracker(const Parameters &parameters, const CameraIndex arity,
+                 const InnerTracker &inner_tracker)
+    : parameters_(parameters),
+      arity_(arity),
       positset_(arity_),
       trackstates_(arity_, kUninitialized),
       trackers_(arity_),
+      decimations_(arity_),
+      statistics_(arity_),
+      metrics_(arity_),
       distorted_input_(false),
       calibration_data_(nullptr),
-      location_valid_(false) {
+      location_valid_(false),
+      fused_(false),
+      localization_(arity_) {
+  auto &registry = Metrics::Instance();
   for (CameraIndex cam = 0; cam < arity_; ++cam) {
     trackers_[cam] = std::move(InnerTrackerPtr(inner_tracker.Clone()));
+
+    const auto label = Metrics::CamLabel(cam);
+    auto &metrics = metrics_[cam];
+    metrics.state = &registry.GetGauge(
+        "dove_eye_tracker_state", label,
+        "Tracker state (0 uninitialized, 1 tracking, 2 lost)");
+    metrics.state_time = &registry.GetGauge(
+        "dove_eye_tracker_state_seconds", label,
+        "Time in the current tracker state");
+    metrics.losses = &registry.GetCounter(
+        "dove_eye_tracker_losses_total", label, "Tracked object lost");
+    metrics.found_projection = &registry.GetCounter(
+        "dove_eye_tracker_reacquisitions_total", label + ",source=\"projection\"",
+        "Lost object found again (by source of the guess)");
+    metrics.found_epiline = &registry.GetCounter(
+        "dove_eye_tracker_reacquisitions_total", label + ",source=\"epiline\"",
+        "Lost object found again (by source of the guess)");
+    metrics.found_global = &registry.GetCounter(
+        "dove_eye_tracker_reacquisitions_total", label + ",source=\"global\"",
+        "Lost object found again (by source of the guess)");
+
+    metrics.state->Set(kUninitialized);
+    metrics.since = Clock::now();
+  }
+}
+
+bool Tracker::SetLocation(const Location location) {
+  location_ = location;
+  location_valid_ = true;
+
+  const auto &params = parameters_.snapshot();
+  location_filter_.Init(params.Get(Parameters::FUSED_KF_PROC_V),
+                        params.Get(Parameters::FUSED_KF_OBS_V));
+  location_filter_.Reset({{location.x, location.y, location.z}});
+
+  return true;
+}
+
+void Tracker::SetState(const CameraIndex cam, const TrackState state) {
+  if (trackstates_[cam] == state) {
+    return;
   }
+
+  trackstates_[cam] = state;
+  metrics_[cam].state->Set(state);
+  metrics_[cam].since = Clock::now();
+}
+
+void Tracker::ResetStatistics() {
+  for (auto &statistics : statistics_) {
+    statistics = Statistics();
+  }
+}
+
+void Tracker::fused(const bool value) {
+  if (fused_ == value) {
+    return;
+  }
+
+  fused_ = value;
+  /* Location from unfused tracking has no velocity, start over */
+  location_valid_ = false;
 }
 
 
 /**
  * @return  true when mark is accepted, false otherwise
  */
-Positset Tracker::SetMark(const Frameset &frameset, const CameraIndex cam,
-                      const InnerTracker::Mark mark, bool project_other) {
+const Positset &Tracker::SetMark(const Frameset &frameset,
+                                 const CameraIndex cam,
+                                 const InnerTracker::Mark mark,
+                                 bool project_other) {
   assert(cam < arity_);
 
   auto tracker = trackers_[cam].get();
@@ -41,7 +114,8 @@ Positset Tracker::SetMark(const Frameset &frameset, const CameraIndex cam,
 
   DEBUG("%i, %i init", cam, success);
   if (success) {
-    trackstates_[cam] = kTracking;
+    SetState(cam, kTracking);
+    ResetDecimation(cam);
   }
 
   if (success && project_other) {
@@ -58,7 +132,8 @@ Positset Tracker::SetMark(const Frameset &frameset, const CameraIndex cam,
       positset_.SetValid(o_cam, o_success);
       DEBUG("%i, %i init", o_cam, o_success);
       if (o_success) {
-        trackstates_[o_cam] = kTracking;
+        SetState(o_cam, kTracking);
+        ResetDecimation(o_cam);
       }
 
       /* All projections must succeed to accept the mark */
@@ -69,9 +144,14 @@ Positset Tracker::SetMark(const Frameset &frameset, const CameraIndex cam,
   return positset_;
 }
 
-Positset Tracker::Track(const Frameset &frameset) {
+const Positset &Tracker::Track(const Frameset &frameset) {
   assert(frameset.Arity() == arity_);
 
+  if (fused_ && calibration_data_) {
+    TrackFused(frameset);
+    return positset_;
+  }
+
   for (CameraIndex cam = 0; cam < arity_; ++cam) {
     (void)TrackSingle(cam, frameset[cam]);
   }
@@ -79,8 +159,68 @@ Positset Tracker::Track(const Frameset &frameset) {
   return positset_;
 }
 
-bool Tracker::TrackSingle(const CameraIndex cam, const Frame &frame) {
+void Tracker::TrackFused(const Frameset &frameset) {
+  if (!location_valid_) {
+    for (CameraIndex cam = 0; cam < arity_; ++cam) {
+      (void)TrackSingle(cam, frameset[cam]);
+    }
+  } else {
+    location_filter_.Predict();
+    const auto position = location_filter_.position_pre();
+    const auto deviation = location_filter_.ObservationDeviation();
+
+    /*
+     * Project predicted location and its deviations along each axis, image
+     * deviation is sum of projected deviations (an upper bound for axis
+     * aligned box).
+     */
+    location_ = Location(position[0], position[1], position[2]);
+    const Point3Vector locations({
+        location_,
+        location_ + Point3(deviation[0], 0, 0),
+        location_ + Point3(0, deviation[1], 0),
+        location_ + Point3(0, 0, deviation[2])});
+
+    for (CameraIndex cam = 0; cam < arity_; ++cam) {
+      const auto points = ReprojectLocations(locations, cam);
+      const auto &expected = points.front();
+      Point2 image_deviation(0, 0);
+      for (size_t i = 1; i < points.size(); ++i) {
+        image_deviation.x += std::abs(points[i].x - expected.x);
+        image_deviation.y += std::abs(points[i].y - expected.y);
+      }
+
+      (void)TrackSingle(cam, frameset[cam], &expected, &image_deviation);
+    }
+  }
+
+  /* Update 3D state from triangulated posits */
+  Location location;
+  if (localization_.Locate(positset_, &location)) {
+    if (location_valid_) {
+      location_filter_.Correct({{location.x, location.y, location.z}});
+      const auto estimate = location_filter_.position_post();
+      location_ = Location(estimate[0], estimate[1], estimate[2]);
+    } else {
+      SetLocation(location);
+    }
+    return;
+  }
+
+  /* Coast on prediction while the object is seen by any camera */
+  bool any_posit = false;
+  for (CameraIndex cam = 0; cam < arity_; ++cam) {
+    any_posit = any_posit || positset_.IsValid(cam);
+  }
+  location_valid_ = location_valid_ && any_posit;
+}
+
+bool Tracker::TrackSingle(const CameraIndex cam, const Frame &frame,
+                          const Point2 *expected,
+                          const Point2 *deviation) {
   auto tracker = trackers_[cam].get();
+  auto &statistics = statistics_[cam];
+  const auto start = Clock::now();
 
   //DEBUG("%s(%i) entry state: %i", __func__, cam, trackstates_[cam]);
 
@@ -91,10 +231,30 @@ bool Tracker::TrackSingle(const CameraIndex cam, const Frame &frame) {
     }
 
     case kTracking: {
-      if (!tracker->Track(frame, &positset_[cam])) {
-        trackstates_[cam] = kLost;
+      if (SkipFrame(cam)) {
+        /* Without prediction the posit is simply missing in this frame */
+        const bool predicted = tracker->Predict(frame, &positset_[cam]);
+        positset_.SetValid(cam, predicted);
+        statistics.skipped += 1;
+        break;
+      }
+
+      const auto track_start = Clock::now();
+      const bool success = expected ?
+          tracker->Track(frame, *expected, *deviation, &positset_[cam]) :
+          tracker->Track(frame, &positset_[cam]);
+      decimations_[cam].busy += Clock::now() - track_start;
+
+      if (!success) {
+        SetState(cam, kLost);
+        statistics.losses += 1;
+        metrics_[cam].losses->Add();
         DEBUG("tracker(%i) lost", cam);
         positset_.SetValid(cam, false);
+        ResetDecimation(cam);
+      } else {
+        positset_.SetValid(cam, true);
+        UpdateDecimation(cam, positset_[cam]);
       }
       break;
     }
@@ -104,7 +264,9 @@ bool Tracker::TrackSingle(const CameraIndex cam, const Frame &frame) {
       if (location_valid_) {
         auto guess = ReprojectLocation(location_, cam);
         if (tracker->ReinitializeTracking(frame, guess, &positset_[cam])) {
-          trackstates_[cam] = kTracking;
+          SetState(cam, kTracking);
+          statistics.found_projection += 1;
+          metrics_[cam].found_projection->Add();
           DEBUG("tracker(%i) found from projection", cam);
           positset_.SetValid(cam, true);
           break;
@@ -129,7 +291,9 @@ bool Tracker::TrackSingle(const CameraIndex cam, const Frame &frame) {
       if (exists_posit) {
         auto epiline = CalculateEpiline(positset_[o_cam], o_cam, cam);
         if (tracker->ReinitializeTracking(frame, epiline, &positset_[cam])) {
-          trackstates_[cam] = kTracking;
+          SetState(cam, kTracking);
+          statistics.found_epiline += 1;
+          metrics_[cam].found_epiline->Add();
           DEBUG("tracker(%i) found from epiline of %i", cam, o_cam);
           positset_.SetValid(cam, true);
           break;
@@ -140,7 +304,9 @@ bool Tracker::TrackSingle(const CameraIndex cam, const Frame &frame) {
        * Lastly try global search on the frame
        */
       if (tracker->ReinitializeTracking(frame, &positset_[cam])) {
-        trackstates_[cam] = kTracking;
+        SetState(cam, kTracking);
+        statistics.found_global += 1;
+        metrics_[cam].found_global->Add();
         DEBUG("tracker(%i) found from global search", cam);
         positset_.SetValid(cam, true);
         break;
@@ -155,12 +321,84 @@ bool Tracker::TrackSingle(const CameraIndex cam, const Frame &frame) {
     positset_[cam] = Undistort(positset_[cam], cam);
   }
 
+  if (trackstates_[cam] != kUninitialized) {
+    const auto now = Clock::now();
+    statistics.frames += 1;
+    statistics.tracked += positset_.IsValid(cam) ? 1 : 0;
+    statistics.time += now - start;
+
+    const std::chrono::duration<double> in_state = now - metrics_[cam].since;
+    metrics_[cam].state_time->Set(in_state.count());
+  }
+
   //DEBUG("%s(%i) exit state: %i, return: %i", __func__, cam, trackstates_[cam],
   //     positset_.IsValid(cam));
 
   return positset_.IsValid(cam);
 }
 
+bool Tracker::SkipFrame(const CameraIndex cam) {
+  auto &decimation = decimations_[cam];
+  const auto budget = parameters_.Get(Parameters::TRACK_BUDGET) / 1000;
+
+  /* Budget is spread over the window, not spent at its beginning */
+  const auto now = Clock::now();
+  const std::chrono::duration<double> elapsed = now - decimation.window_start;
+  if (elapsed.count() >= 1) {
+    decimation.window_start = now;
+    decimation.busy = Clock::duration::zero();
+  }
+  const std::chrono::duration<double> busy = decimation.busy;
+  const bool over_budget = budget > 0 &&
+      busy.count() > budget * elapsed.count();
+
+  if (over_budget || decimation.skipped + 1 < decimation.stride) {
+    decimation.skipped += 1;
+    return true;
+  }
+
+  return false;
+}
+
+void Tracker::UpdateDecimation(const CameraIndex cam, const Posit &posit) {
+  auto &decimation = decimations_[cam];
+  const auto &params = parameters_.snapshot();
+  const int max_stride = params.Get(Parameters::DECIMATION_MAX);
+  const auto max_motion = params.Get(Parameters::DECIMATION_MOTION);
+
+  /* Frames since the last tracked one */
+  const int frames = decimation.skipped + 1;
+
+  if (decimation.has_last) {
+    /* Linear prediction from previously tracked posits */
+    const Point2 predicted = decimation.last + frames * decimation.velocity;
+    const auto error = cv::norm(posit - predicted) / frames;
+
+    decimation.velocity = (1.0 / frames) * (posit - decimation.last);
+    const auto speed = cv::norm(decimation.velocity);
+
+    /* Back off quickly when the object moves, speed up again slowly */
+    if (error > max_motion || speed > max_motion) {
+      decimation.stride = 1;
+    } else {
+      decimation.stride = std::min(max_stride, decimation.stride + 1);
+    }
+  }
+  decimation.stride = std::min(max_stride, decimation.stride);
+
+  decimation.last = posit;
+  decimation.has_last = true;
+  decimation.skipped = 0;
+}
+
+void Tracker::ResetDecimation(const CameraIndex cam) {
+  auto &decimation = decimations_[cam];
+  decimation.stride = 1;
+  decimation.skipped = 0;
+  decimation.has_last = false;
+  decimation.velocity = Point2(0, 0);
+}
+
 Point2 Tracker::Undistort(const Point2 &point, const CameraIndex cam) const {
   assert(calibration_data_);
   // TODO verify this routine
@@ -194,9 +432,15 @@ InnerTracker::Epiline Tracker::CalculateEpiline(
 
 Point2 Tracker::ReprojectLocation(const Location location,
                                        const CameraIndex cam) const {
+  Point3Vector object_points({static_cast<Point3>(location)});
+
+  return ReprojectLocations(object_points, cam).front();
+}
+
+Point2Vector Tracker::ReprojectLocations(const Point3Vector &object_points,
+                                         const CameraIndex cam) const {
   assert(calibration_data_);
 
-  Point3Vector object_points({static_cast<Point3>(location)});
   Point2Vector image_points;
 
   auto R = calibration_data_->CameraRotation(cam);
@@ -211,7 +455,7 @@ Point2 Tracker::ReprojectLocation(const Location location,
     projectPoints(object_points, R, t, C, cv::noArray(), image_points);
   }
 
-  return image_points.front();
+  return image_points;
 }
 
 } // namespace dove_eye
@@ -0,0 +1,26 @@
+#ifndef DOVE_EYE_TEST_CHECK_H_
+#define DOVE_EYE_TEST_CHECK_H_
+
+#include <cstdio>
+
+/*
+ * Minimal checks for single file test programs, failures are reported and
+ * counted, test returns test::failures from main().
+ */
+
+namespace test {
+
+static int failures = 0;
+
+} // namespace test
+
+#define CHECK(COND)                                                  \
+    do {                                                             \
+      if (!(COND)) {                                                 \
+        fprintf(stderr, "%s:%i: check failed: %s\n", __FILE__,      \
+                __LINE__, #COND);                                    \
+        ++test::failures;                                            \
+      }                                                              \
+    } while (0)
+
+#endif // DOVE_EYE_TEST_CHECK_H_
@@ -0,0 +1,147 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "check.h"
+#include "dove_eye/histogram_tracker.h"
+#include "dove_eye/parameters.h"
+
+using dove_eye::HistogramTracker;
+using dove_eye::Parameters;
+using std::vector;
+
+namespace {
+
+/** Largest difference of reference and tracker blob edges in pixels */
+const int kEdgeTolerance = 2;
+
+const cv::Scalar kBackground(128, 128, 128);
+const cv::Scalar kObject(0, 0, 255);
+
+/** Search and initialization are protected, the test calls them directly */
+class TestTracker : public HistogramTracker {
+ public:
+  explicit TestTracker(const Parameters &parameters)
+      : HistogramTracker(parameters) {
+  }
+
+  using HistogramTracker::InitTrackerData;
+  using HistogramTracker::Search;
+};
+
+/** Fixed frame, background (no saturation) is never part of the object
+ *
+ * The ring is the largest blob, its provisional labels merge only at the
+ * bottom. Disc is the second largest, dot and line vanish in the blur.
+ */
+cv::Mat FrameData() {
+  cv::Mat data(240, 320, CV_8UC3, kBackground);
+  cv::circle(data, cv::Point(220, 130), 33, kObject, 14);
+  cv::circle(data, cv::Point(70, 80), 25, kObject, -1);
+  cv::circle(data, cv::Point(40, 200), 4, kObject, -1);
+  cv::line(data, cv::Point(100, 200), cv::Point(300, 210), kObject, 1);
+  return data;
+}
+
+/** Blob of the Gaussian blur + findContours implementation
+ *
+ * Backprojection of the object's histogram is 255 on object pixels and 0
+ * elsewhere (background is outside of the object's saturation range).
+ */
+cv::Rect ReferenceBlob(const cv::Mat &data, const Parameters &parameters) {
+  cv::Mat backproj;
+  cv::inRange(data, kObject, kObject, backproj);
+
+  auto radius = parameters.Get(Parameters::TEMPLATE_RADIUS);
+  cv::Size blur_size(radius, radius);
+  blur_size.width += 1 - (blur_size.width % 2);
+  blur_size.height += 1 - (blur_size.height % 2);
+  cv::GaussianBlur(backproj, backproj, blur_size, 0);
+
+  const auto threshold = parameters.Get(Parameters::SEARCH_THRESHOLD);
+  cv::threshold(backproj, backproj, threshold * 255, 255, cv::THRESH_BINARY);
+
+  vector<vector<cv::Point>> contours;
+  cv::findContours(backproj, contours,
+                   cv::noArray(), /* hierarchy */
+                   CV_RETR_LIST,
+                   CV_CHAIN_APPROX_SIMPLE);
+
+  double max_area = 0;
+  const vector<cv::Point> *best_contour = nullptr;
+  for (auto &contour : contours) {
+    auto area = cv::contourArea(contour);
+    if (area < max_area) {
+      continue;
+    }
+    max_area = area;
+    best_contour = &contour;
+  }
+
+  return best_contour ? cv::boundingRect(*best_contour) : cv::Rect();
+}
+
+bool SimilarRects(const cv::Rect &lhs, const cv::Rect &rhs) {
+  return std::abs(lhs.x - rhs.x) <= kEdgeTolerance &&
+      std::abs(lhs.y - rhs.y) <= kEdgeTolerance &&
+      std::abs(lhs.br().x - rhs.br().x) <= kEdgeTolerance &&
+      std::abs(lhs.br().y - rhs.br().y) <= kEdgeTolerance;
+}
+
+cv::Rect MarkToRect(const HistogramTracker::Mark &mark) {
+  return cv::Rect(mark.top_left, mark.top_left + mark.size);
+}
+
+void CompareWithReference() {
+  Parameters parameters;
+  TestTracker tracker(parameters);
+  const auto data = FrameData();
+
+  /* Histogram from the inside of the disc */
+  HistogramTracker::Mark init_mark(HistogramTracker::Mark::kRectangle);
+  init_mark.top_left = dove_eye::Point2(60, 70);
+  init_mark.size = dove_eye::Point2(20, 20);
+  CHECK(tracker.InitTrackerData(data, init_mark));
+
+  const auto threshold = parameters.Get(Parameters::SEARCH_THRESHOLD);
+  const auto expected = ReferenceBlob(data, parameters);
+  CHECK(expected.area() > 0);
+  /* It must be the ring */
+  CHECK(expected.contains(cv::Point(220, 130)));
+
+  HistogramTracker::Mark mark(HistogramTracker::Mark::kInvalid);
+  CHECK(tracker.Search(data, tracker.tracker_data(), nullptr, nullptr,
+                       threshold, &mark));
+  CHECK(mark.type == HistogramTracker::Mark::kRectangle);
+
+  const auto blob = MarkToRect(mark);
+  if (!SimilarRects(blob, expected)) {
+    fprintf(stderr, "blob [%i, %i, %i, %i], reference [%i, %i, %i, %i]\n",
+            blob.x, blob.y, blob.width, blob.height,
+            expected.x, expected.y, expected.width, expected.height);
+  }
+  CHECK(SimilarRects(blob, expected));
+
+  /* Search in ROI finds the same blob in frame coordinates */
+  const cv::Rect roi(150, 60, 150, 150);
+  HistogramTracker::Mark roi_mark(HistogramTracker::Mark::kInvalid);
+  CHECK(tracker.Search(data, tracker.tracker_data(), &roi, nullptr,
+                       threshold, &roi_mark));
+  CHECK(MarkToRect(roi_mark) == blob);
+
+  /* Nothing above threshold */
+  const cv::Mat empty(data.size(), data.type(), kBackground);
+  HistogramTracker::Mark empty_mark(HistogramTracker::Mark::kInvalid);
+  CHECK(!tracker.Search(empty, tracker.tracker_data(), nullptr, nullptr,
+                        threshold, &empty_mark));
+}
+
+} // anonymous namespace
+
+int main() {
+  CompareWithReference();
+
+  return test::failures;
+}
@@ -0,0 +1,98 @@
+#include <cstdio>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "check.h"
+#include "dove_eye/frameset.h"
+#include "dove_eye/parameters.h"
+#include "dove_eye/recorder.h"
+#include "dove_eye/recording_format.h"
+#include "dove_eye/recording_video_provider.h"
+
+using dove_eye::CameraIndex;
+using dove_eye::Frame;
+using dove_eye::Frameset;
+using dove_eye::Parameters;
+using dove_eye::Recorder;
+using dove_eye::RecordingVideoProvider;
+using std::vector;
+
+namespace {
+
+const CameraIndex kArity = 2;
+const size_t kFramesets = 20;
+const double kPeriod = 1 / 30.0;
+
+/** Distinct content of every frame */
+cv::Mat FrameData(const CameraIndex cam, const size_t frame_no) {
+  cv::Mat data(48, 64, CV_8UC3, cv::Scalar(frame_no, cam, 255 - frame_no));
+  cv::circle(data, cv::Point(frame_no % 64, 24), 5, cv::Scalar(0, 255, 0), -1);
+  return data;
+}
+
+double FrameTimestamp(const CameraIndex cam, const size_t frame_no) {
+  /* Cameras aren't synchronized */
+  return (frame_no + 1) * kPeriod + cam * kPeriod / 3;
+}
+
+/** Record framesets and replay them from streams, frames must match */
+void RoundTrip(const dove_eye::recording::Codec codec) {
+  const std::string basename = "recording_test";
+  Parameters parameters;
+
+  {
+    Recorder recorder(parameters, kArity);
+    CHECK(recorder.Start(basename, codec));
+
+    /* Less framesets than the queue holds, none is dropped */
+    for (size_t i = 0; i < kFramesets; ++i) {
+      Frameset frameset(kArity, i);
+      for (CameraIndex cam = 0; cam < kArity; ++cam) {
+        frameset.Emplace(cam, Frame{FrameTimestamp(cam, i), FrameData(cam, i)});
+      }
+      recorder.Record(frameset);
+    }
+
+    recorder.Stop();
+    CHECK(recorder.recorded() == kFramesets);
+    CHECK(recorder.dropped() == 0);
+  }
+
+  for (CameraIndex cam = 0; cam < kArity; ++cam) {
+    const auto filename = dove_eye::recording::StreamFilename(basename, cam);
+    RecordingVideoProvider provider(filename);
+
+    size_t frame_no = 0;
+    for (auto frame : provider) {
+      CHECK(frame_no < kFramesets);
+      if (frame_no >= kFramesets) {
+        break;
+      }
+
+      CHECK(!frame.data.empty());
+      CHECK(frame.timestamp == FrameTimestamp(cam, frame_no));
+      if (!frame.data.empty()) {
+        const auto expected = FrameData(cam, frame_no);
+        CHECK(frame.data.size() == expected.size());
+        CHECK(frame.data.type() == expected.type());
+        CHECK(cv::norm(frame.data, expected, cv::NORM_INF) == 0);
+      }
+      ++frame_no;
+    }
+    CHECK(frame_no == kFramesets);
+
+    remove(filename.c_str());
+  }
+
+  remove(dove_eye::recording::LogFilename(basename).c_str());
+}
+
+} // anonymous namespace
+
+int main() {
+  RoundTrip(dove_eye::recording::kRaw);
+  RoundTrip(dove_eye::recording::kPng);
+
+  return test::failures;
+}
@@ -0,0 +1,223 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <new>
+
+using std::string;
+using std::vector;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+std::atomic<size_t> allocations(0);
+std::atomic<size_t> copies(0);
+
+double TimeBatch(const bench::Runner::Body &body, const size_t iterations) {
+  const auto start = Clock::now();
+  body(iterations);
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  return elapsed.count();
+}
+
+/** Value of "key": in the line, false when missing */
+bool FindValue(const string &line, const string &key, string *value) {
+  const string pattern = "\"" + key + "\": ";
+  auto begin = line.find(pattern);
+  if (begin == string::npos) {
+    return false;
+  }
+  begin += pattern.size();
+
+  if (line[begin] == '"') {
+    auto end = line.find('"', begin + 1);
+    if (end == string::npos) {
+      return false;
+    }
+    *value = line.substr(begin + 1, end - begin - 1);
+  } else {
+    auto end = line.find_first_of(",}", begin);
+    *value = line.substr(begin, end - begin);
+  }
+
+  return true;
+}
+
+} // anonymous namespace
+
+/* Replaced globally, so that allocations of libraries are counted too */
+void *operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *result = std::malloc(size ? size : 1)) {
+    return result;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+namespace bench {
+
+void CountCopies(const size_t count) {
+  copies.fetch_add(count, std::memory_order_relaxed);
+}
+
+void Runner::Add(const string &name, const Factory &factory) {
+  benchmarks_.push_back({name, factory});
+}
+
+void Runner::Run(std::ostream &log) {
+  for (auto &benchmark : benchmarks_) {
+    if (benchmark.name.find(filter_) == string::npos) {
+      continue;
+    }
+
+    log << std::left << std::setw(48) << benchmark.name << std::flush;
+
+    const auto body = benchmark.factory();
+    const auto result = Measure(benchmark.name, body);
+    results_.push_back(result);
+
+    log << std::right << std::fixed << std::setprecision(1)
+        << std::setw(14) << result.ns_per_op << " ns/op"
+        << std::setw(12) << result.iterations << " it"
+        << std::setw(10) << result.allocs_per_op << " allocs/op";
+    if (result.copies_per_op > 0) {
+      log << std::setw(8) << result.copies_per_op << " copies/op";
+    }
+    log << std::endl;
+  }
+}
+
+void Runner::List(std::ostream &out) const {
+  for (auto &benchmark : benchmarks_) {
+    if (benchmark.name.find(filter_) != string::npos) {
+      out << benchmark.name << std::endl;
+    }
+  }
+}
+
+Runner::Result Runner::Measure(const string &name, const Body &body) const {
+  const double batch_time = min_time_ / kBatches;
+
+  /* Warm up and find batch size */
+  size_t iterations = 1;
+  while (TimeBatch(body, iterations) < batch_time &&
+         iterations < std::numeric_limits<size_t>::max() / 2) {
+    iterations *= 2;
+  }
+
+  allocations = 0;
+  copies = 0;
+
+  vector<double> times;
+  for (int batch = 0; batch < kBatches; ++batch) {
+    times.push_back(TimeBatch(body, iterations) * 1e9 / iterations);
+  }
+  std::sort(times.begin(), times.end());
+
+  const double operations = static_cast<double>(iterations) * kBatches;
+  return {name, iterations, times[times.size() / 2], times.front(),
+          allocations / operations, copies / operations};
+}
+
+
+void WriteJson(const Runner::ResultVector &results, std::ostream &out) {
+  out << "{" << std::endl;
+  out << "  \"benchmarks\": [" << std::endl;
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    auto &result = results[i];
+    out << "    {\"name\": \"" << result.name << "\", "
+        << "\"iterations\": " << result.iterations << ", "
+        << std::fixed << std::setprecision(3)
+        << "\"ns_per_op\": " << result.ns_per_op << ", "
+        << "\"ns_min\": " << result.ns_min << ", "
+        << "\"allocs_per_op\": " << result.allocs_per_op << ", "
+        << "\"copies_per_op\": " << result.copies_per_op << "}"
+        << ((i + 1 < results.size()) ? "," : "") << std::endl;
+  }
+
+  out << "  ]" << std::endl;
+  out << "}" << std::endl;
+}
+
+bool ReadJson(const string &filename, Runner::ResultVector *results) {
+  std::ifstream file(filename);
+  if (!file) {
+    return false;
+  }
+
+  string line;
+  while (std::getline(file, line)) {
+    Runner::Result result;
+    string iterations;
+    string ns_per_op;
+    string ns_min;
+    if (!FindValue(line, "name", &result.name) ||
+        !FindValue(line, "iterations", &iterations) ||
+        !FindValue(line, "ns_per_op", &ns_per_op) ||
+        !FindValue(line, "ns_min", &ns_min)) {
+      continue;
+    }
+
+    result.iterations = std::stoull(iterations);
+    result.ns_per_op = std::stod(ns_per_op);
+    result.ns_min = std::stod(ns_min);
+
+    /* Counters are missing in older baselines */
+    string count;
+    result.allocs_per_op = FindValue(line, "allocs_per_op", &count) ?
+        std::stod(count) : 0;
+    result.copies_per_op = FindValue(line, "copies_per_op", &count) ?
+        std::stod(count) : 0;
+    results->push_back(result);
+  }
+
+  return true;
+}
+
+size_t Compare(const Runner::ResultVector &results,
+               const Runner::ResultVector &baseline,
+               const double tolerance,
+               std::ostream &report) {
+  std::map<string, const Runner::Result *> baseline_map;
+  for (auto &result : baseline) {
+    baseline_map[result.name] = &result;
+  }
+
+  size_t regressions = 0;
+  for (auto &result : results) {
+    report << std::left << std::setw(48) << result.name;
+
+    auto it = baseline_map.find(result.name);
+    if (it == baseline_map.end()) {
+      report << "  (no baseline)" << std::endl;
+      continue;
+    }
+
+    const double ratio = result.ns_per_op / it->second->ns_per_op;
+    const bool regression = ratio > 1 + tolerance;
+    regressions += regression ? 1 : 0;
+
+    report << std::right << std::fixed << std::setprecision(1)
+           << std::setw(14) << it->second->ns_per_op << " ->"
+           << std::setw(14) << result.ns_per_op << " ns/op  "
+           << std::showpos << std::setw(7) << (ratio - 1) * 100 << " %"
+           << std::noshowpos
+           << (regression ? "  REGRESSION" : "") << std::endl;
+  }
+
+  return regressions;
+}
+
+} // namespace bench
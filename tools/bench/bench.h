@@ -0,0 +1,101 @@
+#ifndef DOVE_EYE_BENCH_BENCH_H_
+#define DOVE_EYE_BENCH_BENCH_H_
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+/** Minimal benchmark runner
+ *
+ * Benchmark is a factory that prepares its (possibly expensive) state and
+ * returns body, body runs the measured operation given number of times.
+ * Factories of filtered out benchmarks are never called.
+ *
+ * Number of iterations is doubled until a batch takes 1/kBatches of
+ * min_time, then kBatches batches are measured. Median of per-operation
+ * times is reported (robust to scheduler noise), minimum is kept too.
+ *
+ * Heap allocations (operator new in any thread) and copies reported by the
+ * body (CountCopies()) are averaged over the measured batches.
+ */
+class Runner {
+ public:
+  typedef std::function<void(const size_t iterations)> Body;
+  typedef std::function<Body()> Factory;
+
+  struct Result {
+    std::string name;
+    size_t iterations;
+    double ns_per_op;
+    double ns_min;
+    double allocs_per_op;
+    double copies_per_op;
+  };
+
+  typedef std::vector<Result> ResultVector;
+
+  static const int kBatches = 5;
+
+  Runner(const std::string &filter, const double min_time)
+      : filter_(filter),
+        min_time_(min_time) {
+  }
+
+  void Add(const std::string &name, const Factory &factory);
+
+  /** Run all matching benchmarks, progress is written to log */
+  void Run(std::ostream &log);
+
+  void List(std::ostream &out) const;
+
+  inline const ResultVector &results() const {
+    return results_;
+  }
+
+ private:
+  struct Benchmark {
+    std::string name;
+    Factory factory;
+  };
+
+  const std::string filter_;
+  const double min_time_;
+
+  std::vector<Benchmark> benchmarks_;
+  ResultVector results_;
+
+  Result Measure(const std::string &name, const Body &body) const;
+};
+
+/** Write results as JSON, one benchmark per line */
+void WriteJson(const Runner::ResultVector &results, std::ostream &out);
+
+/** Read results written by WriteJson() */
+bool ReadJson(const std::string &filename, Runner::ResultVector *results);
+
+/** Compare results with baseline and write report
+ *
+ * \param tolerance   allowed relative slowdown (e.g. 0.1 for 10 %)
+ * \return            number of regressions
+ */
+size_t Compare(const Runner::ResultVector &results,
+               const Runner::ResultVector &baseline,
+               const double tolerance,
+               std::ostream &report);
+
+/** Report copies (of data the body should only share) to the runner */
+void CountCopies(const size_t count = 1);
+
+/** Keep compiler from optimizing out computed value */
+template<typename T>
+inline void DoNotOptimize(const T &value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+} // namespace bench
+
+#endif // DOVE_EYE_BENCH_BENCH_H_
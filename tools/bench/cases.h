@@ -0,0 +1,81 @@
+#ifndef DOVE_EYE_BENCH_CASES_H_
+#define DOVE_EYE_BENCH_CASES_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "bench.h"
+#include "dove_eye/aggregator.h"
+#include "dove_eye/frameset.h"
+#include "dove_eye/parameters.h"
+#include "dove_eye/synthetic_scene.h"
+#include "dove_eye/video_provider.h"
+
+namespace bench {
+
+typedef std::shared_ptr<const dove_eye::SyntheticScene> ScenePtr;
+typedef std::vector<dove_eye::Frameset> FramesetVector;
+
+void AddTrackerBenchmarks(const dove_eye::Parameters &parameters,
+                          Runner *runner);
+
+void AddPipelineBenchmarks(const dove_eye::Parameters &parameters,
+                           Runner *runner);
+
+void AddGuiBenchmarks(const dove_eye::Parameters &parameters,
+                      Runner *runner);
+
+/** Ball moving on a closed loop (period is the whole scene) */
+ScenePtr LoopScene(const dove_eye::CameraIndex arity,
+                   const dove_eye::SyntheticScene::Settings &settings =
+                       dove_eye::SyntheticScene::Settings());
+
+/** All frames of the scene, rendered upfront by SyntheticVideoProvider
+ *
+ * Frameset i consists of frames number i (not aggregated), so that every
+ * frame of the scene is used.
+ */
+FramesetVector RenderFramesets(const ScenePtr &scene);
+
+/** SyntheticVideoProvider of each camera (owned by the caller) */
+dove_eye::Aggregator::ProvidersContainer SyntheticProviders(
+    const ScenePtr &scene);
+
+/** Random 8-bit BGR image */
+cv::Mat TestImage(const int width, const int height);
+
+/** Endless stream of the same image (no decoding cost)
+ *
+ * Every frame shares the image buffer, frame with different buffer was
+ * copied on its way.
+ */
+class StaticVideoProvider : public dove_eye::VideoProvider {
+ public:
+  StaticVideoProvider(const cv::Mat &data, const double fps)
+      : data_(data),
+        fps_(fps) {
+  }
+
+  inline std::string Id() const override {
+    return "static";
+  }
+
+  inline const cv::Mat &data() const {
+    return data_;
+  }
+
+  dove_eye::FrameIterator begin() override;
+
+  dove_eye::FrameIterator end() override;
+
+ private:
+  const cv::Mat data_;
+  const double fps_;
+};
+
+} // namespace bench
+
+#endif // DOVE_EYE_BENCH_CASES_H_
@@ -0,0 +1,116 @@
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+#include "cases.h"
+#include "dove_eye/frame_iterator.h"
+#include "dove_eye/synthetic_video_provider.h"
+
+using dove_eye::Aggregator;
+using dove_eye::CameraIndex;
+using dove_eye::Frame;
+using dove_eye::FrameIterator;
+using dove_eye::FrameIteratorImpl;
+using dove_eye::Frameset;
+using dove_eye::Location;
+using dove_eye::SyntheticScene;
+using dove_eye::SyntheticVideoProvider;
+
+namespace {
+
+class StaticFrameIterator : public FrameIteratorImpl {
+ public:
+  StaticFrameIterator(const cv::Mat &data, const double fps)
+      : fps_(fps),
+        frame_no_(0) {
+    frame_.data = data;
+    frame_.timestamp = 1 / fps_;
+  }
+
+  inline Frame GetFrame() const override {
+    return frame_;
+  }
+
+  inline void MoveNext() override {
+    ++frame_no_;
+    frame_.timestamp = (frame_no_ + 1) / fps_;
+  }
+
+  inline bool IsValid() override {
+    return true;
+  }
+
+ private:
+  const double fps_;
+  size_t frame_no_;
+  Frame frame_;
+};
+
+} // anonymous namespace
+
+namespace bench {
+
+ScenePtr LoopScene(const CameraIndex arity,
+                   const SyntheticScene::Settings &settings) {
+  const int kWaypoints = 16;
+  const double kPeriod = 2;
+  const double kRadius = 0.2;
+  const double kDistance = 2;
+
+  /* Horizontal circle around the point cameras are looking at */
+  SyntheticScene::Trajectory trajectory;
+  for (int i = 0; i <= kWaypoints; ++i) {
+    const double angle = 2 * M_PI * i / kWaypoints;
+    trajectory.push_back({kPeriod * i / kWaypoints,
+                          Location(kRadius * std::cos(angle), 0,
+                                   kDistance + kRadius * std::sin(angle))});
+  }
+
+  auto calibration_data = SyntheticScene::CreateRig(arity,
+                                                    settings.width,
+                                                    settings.height);
+  return ScenePtr(new SyntheticScene(calibration_data, trajectory, settings));
+}
+
+FramesetVector RenderFramesets(const ScenePtr &scene) {
+  FramesetVector result;
+  for (size_t frame_no = 0; frame_no < scene->FrameCount(); ++frame_no) {
+    result.emplace_back(scene->Arity(), frame_no);
+  }
+
+  for (CameraIndex cam = 0; cam < scene->Arity(); ++cam) {
+    SyntheticVideoProvider provider(scene, cam);
+    size_t frame_no = 0;
+    for (auto frame : provider) {
+      assert(frame_no < result.size());
+      result[frame_no].Emplace(cam, std::move(frame));
+      ++frame_no;
+    }
+  }
+
+  return result;
+}
+
+Aggregator::ProvidersContainer SyntheticProviders(const ScenePtr &scene) {
+  Aggregator::ProvidersContainer result;
+  for (CameraIndex cam = 0; cam < scene->Arity(); ++cam) {
+    result.push_back(new SyntheticVideoProvider(scene, cam));
+  }
+  return result;
+}
+
+cv::Mat TestImage(const int width, const int height) {
+  cv::Mat result(height, width, CV_8UC3);
+  cv::randu(result, cv::Scalar::all(0), cv::Scalar::all(255));
+  return result;
+}
+
+FrameIterator StaticVideoProvider::begin() {
+  return FrameIterator(this, new StaticFrameIterator(data_, fps_));
+}
+
+FrameIterator StaticVideoProvider::end() {
+  return FrameIterator(this);
+}
+
+} // namespace bench
@@ -0,0 +1,292 @@
+#include <memory>
+
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QSize>
+
+#include "cases.h"
+#include "controller.h"
+#include "dove_eye/blocking_policy.h"
+#include "dove_eye/camera_calibration.h"
+#include "dove_eye/chessboard_pattern.h"
+#include "dove_eye/frameset_aggregator.h"
+#include "dove_eye/localization.h"
+#include "dove_eye/location_publisher.h"
+#include "dove_eye/motion_time_calibration.h"
+#include "dove_eye/preview.h"
+#include "dove_eye/recorder.h"
+#include "dove_eye/template_tracker.h"
+#include "dove_eye/tracker.h"
+#include "frameset_converter.h"
+#include "receiver.h"
+
+using dove_eye::Aggregator;
+using dove_eye::BlockingPolicy;
+using dove_eye::CameraCalibration;
+using dove_eye::CameraIndex;
+using dove_eye::ChessboardPattern;
+using dove_eye::Frameset;
+using dove_eye::FramesetAggregator;
+using dove_eye::FramesetPtr;
+using dove_eye::Localization;
+using dove_eye::LocationPublisher;
+using dove_eye::MotionTimeCalibration;
+using dove_eye::Parameters;
+using dove_eye::Positset;
+using dove_eye::Recorder;
+using dove_eye::TemplateTracker;
+using dove_eye::Tracker;
+
+namespace {
+
+const CameraIndex kArity = 3;
+const double kFps = 30;
+
+/** Converter displaying all cameras
+ *
+ * Rate limit is bypassed (every frameset is converted on arrival) so that
+ * each iteration includes preview and QImage creation.
+ */
+std::shared_ptr<FramesetConverter> ShownConverter(
+    const Parameters &parameters) {
+  auto converter = std::make_shared<FramesetConverter>(parameters, kArity);
+  converter->allow_drop(false);
+  for (CameraIndex cam = 0; cam < kArity; ++cam) {
+    converter->SetFrameSize(cam, QSize(320, 240));
+  }
+  return converter;
+}
+
+/** Frameset conversion to images including the event loop round trip
+ *
+ * \param queued  deliver the frameset via queued invocation (as signals from
+ *                controller's thread are), otherwise call the slot
+ */
+bench::Runner::Body ConvertFramesetBody(const bool queued) {
+  struct State {
+    /* Declared first, converter keeps a reference */
+    Parameters parameters;
+    std::shared_ptr<FramesetConverter> converter;
+    FramesetPtr frameset;
+  };
+
+  auto scene = bench::LoopScene(kArity);
+  auto state = std::make_shared<State>();
+  state->frameset = std::make_shared<const Frameset>(
+      bench::RenderFramesets(scene)[0]);
+  state->converter = ShownConverter(state->parameters);
+
+  return [state, queued](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      if (queued) {
+        QMetaObject::invokeMethod(state->converter.get(), "ProcessFrameset",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(dove_eye::FramesetPtr,
+                                        state->frameset));
+      } else {
+        state->converter->ProcessFrameset(state->frameset);
+      }
+      QCoreApplication::processEvents();
+    }
+  };
+}
+
+/** Queued delivery of a frameset only (no conversion)
+ *
+ * \param by_value  pass the frameset by value (copied into the event, as
+ *                  FramesetReady used to), otherwise pass the shared handle
+ */
+bench::Runner::Body DeliverFramesetBody(const bool by_value) {
+  struct State {
+    bench::FramesetReceiver receiver;
+    Frameset frameset;
+    FramesetPtr frameset_ptr;
+  };
+
+  auto scene = bench::LoopScene(kArity);
+  auto state = std::make_shared<State>();
+  state->frameset = bench::RenderFramesets(scene)[0];
+  state->frameset_ptr = std::make_shared<const Frameset>(state->frameset);
+
+  return [state, by_value](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      if (by_value) {
+        QMetaObject::invokeMethod(&state->receiver, "ReceiveFrameset",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(dove_eye::Frameset,
+                                        state->frameset));
+      } else {
+        QMetaObject::invokeMethod(&state->receiver, "ReceiveFramesetPtr",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(dove_eye::FramesetPtr,
+                                        state->frameset_ptr));
+      }
+      QCoreApplication::processEvents();
+    }
+  };
+}
+
+/** Conversion of full frames as before previews (for converter/frameset)
+ *
+ * Every frame was cloned, resized to the viewer and color converted on the
+ * GUI thread.
+ */
+bench::Runner::Body FullFrameConvertBody() {
+  auto scene = bench::LoopScene(kArity);
+  const auto frameset = std::make_shared<const Frameset>(
+      bench::RenderFramesets(scene)[0]);
+
+  return [frameset](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      FramesetConverter::ImageList image_list(kArity);
+      for (CameraIndex cam = 0; cam < kArity; ++cam) {
+        auto mat = (*frameset)[cam].data.clone();
+        /* Viewer of ShownConverter() */
+        const cv::Size size(320, 320 * mat.rows / mat.cols);
+        cv::resize(mat, mat, size);
+        cv::cvtColor(mat, mat, CV_BGR2RGB);
+
+        const uchar *data = mat.data;
+        image_list[cam] = QImage(data, mat.cols, mat.rows, mat.step,
+                                 QImage::Format_RGB888, [](void *mat) {
+                                   delete static_cast<cv::Mat *>(mat);
+                                 }, new cv::Mat(mat));
+      }
+      bench::DoNotOptimize(image_list);
+    }
+  };
+}
+
+/** Controller::FramesetLoop feeding the converter over queued connection
+ *
+ * Data path of the application in idle mode (aggregator, shared frameset,
+ * queued signal, conversion), controller and converter only share the
+ * thread here. Delivered frames whose pixels aren't the providers' buffer
+ * are counted as copies.
+ */
+bench::Runner::Body FramesetLoopBody() {
+  struct State {
+    /* Declared first, controller and converter keep a reference */
+    Parameters parameters;
+    std::shared_ptr<FramesetConverter> converter;
+    std::unique_ptr<Controller> controller;
+  };
+
+  auto state = std::make_shared<State>();
+  auto &parameters = state->parameters;
+  state->converter = ShownConverter(parameters);
+
+  const auto image = bench::TestImage(640, 480);
+  Aggregator::ProvidersContainer providers;
+  for (CameraIndex cam = 0; cam < kArity; ++cam) {
+    providers.push_back(new bench::StaticVideoProvider(image, kFps));
+  }
+
+  auto pattern = new ChessboardPattern(
+      parameters.Get(Parameters::CALIBRATION_ROWS),
+      parameters.Get(Parameters::CALIBRATION_COLS),
+      parameters.Get(Parameters::CALIBRATION_SIZE));
+  state->controller.reset(new Controller(
+          parameters,
+          new FramesetAggregator<BlockingPolicy>(providers, parameters),
+          new CameraCalibration(parameters, kArity, pattern),
+          new Tracker(parameters, kArity, TemplateTracker(parameters)),
+          new Localization(kArity),
+          new MotionTimeCalibration(parameters, kArity),
+          new Recorder(parameters, kArity),
+          new LocationPublisher(kArity)));
+
+  const auto controller = state->controller.get();
+  const auto converter = state->converter.get();
+  QObject::connect(controller, &Controller::FramesetReady,
+                   converter, &FramesetConverter::ProcessFrameset,
+                   Qt::QueuedConnection);
+
+  const uchar *pixels = image.data;
+  QObject::connect(controller, &Controller::FramesetReady,
+                   converter, [pixels](const FramesetPtr frameset) {
+                     for (CameraIndex cam = 0; cam < kArity; ++cam) {
+                       if (frameset->IsValid(cam) &&
+                           (*frameset)[cam].data.data != pixels) {
+                         bench::CountCopies();
+                       }
+                     }
+                   }, Qt::QueuedConnection);
+
+  controller->Start(true);
+
+  return [state](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      state->controller->Step();
+      QCoreApplication::processEvents();
+    }
+  };
+}
+
+/** Downscaled previews of all cameras (part of converter/frameset) */
+bench::Runner::Body PreviewFramesetBody(const Parameters &parameters) {
+  auto scene = bench::LoopScene(kArity);
+  const auto frameset = std::make_shared<const Frameset>(
+      bench::RenderFramesets(scene)[0]);
+  auto generator = std::make_shared<dove_eye::PreviewGenerator>(parameters,
+                                                                kArity);
+
+  return [generator, frameset](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      generator->Process(*frameset);
+      bench::DoNotOptimize(generator->preview(0));
+    }
+  };
+}
+
+bench::Runner::Body ConvertPositsetBody(const Parameters &parameters) {
+  auto scene = bench::LoopScene(kArity);
+  const auto frameset = std::make_shared<Frameset>(
+      bench::RenderFramesets(scene)[0]);
+  const auto positset = scene->PositsetAt((*frameset)[0].timestamp);
+
+  /* Converter needs frame sizes from a frameset first */
+  auto converter = ShownConverter(parameters);
+  converter->ProcessFrameset(frameset);
+  QCoreApplication::processEvents();
+
+  return [converter, positset](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      converter->ProcessPositset(positset);
+      QCoreApplication::processEvents();
+    }
+  };
+}
+
+} // anonymous namespace
+
+namespace bench {
+
+void AddGuiBenchmarks(const Parameters &parameters, Runner *runner) {
+  runner->Add("converter/frameset/arity3", [] {
+                return ConvertFramesetBody(false);
+              });
+  runner->Add("converter/frameset/full_frame/arity3", [] {
+                return FullFrameConvertBody();
+              });
+  runner->Add("converter/frameset/queued/arity3", [] {
+                return ConvertFramesetBody(true);
+              });
+  runner->Add("connection/frameset/by_value/arity3", [] {
+                return DeliverFramesetBody(true);
+              });
+  runner->Add("connection/frameset/shared/arity3", [] {
+                return DeliverFramesetBody(false);
+              });
+  runner->Add("controller/frameset_loop/arity3", [] {
+                return FramesetLoopBody();
+              });
+  runner->Add("converter/positset/arity3", [&parameters] {
+                return ConvertPositsetBody(parameters);
+              });
+  runner->Add("preview/frameset/arity3", [&parameters] {
+                return PreviewFramesetBody(parameters);
+              });
+}
+
+} // namespace bench
@@ -0,0 +1,129 @@
+/** Benchmarks of hot paths of the tracking pipeline
+ *
+ * Benchmarks run on synthetic scenes (no cameras or video files needed).
+ * Results are printed as JSON (to stdout or -o file), progress goes to
+ * stderr. With -b, results are compared against a previously saved run and
+ * exit status is non-zero when any benchmark is slower by more than the
+ * tolerance.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <QCoreApplication>
+#include <unistd.h>
+
+#include "bench.h"
+#include "cases.h"
+#include "dove_eye/parameters.h"
+#include "metatypes.h"
+
+using dove_eye::Parameters;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+
+namespace {
+
+void PrintUsage(const string &name) {
+  cout << "Usage: " << name <<
+      " [-l] [-f filter] [-t min_time] [-o output] [-b baseline]"
+      " [-r tolerance]" << endl;
+  cout << "  -l  list benchmarks and exit" << endl;
+  cout << "  -f  run only benchmarks whose name contains filter" << endl;
+  cout << "  -t  measuring time per benchmark [s] (default 1)" << endl;
+  cout << "  -o  write JSON results to file (default stdout)" << endl;
+  cout << "  -b  compare with results of a previous run" << endl;
+  cout << "  -r  allowed relative slowdown (default 0.1)" << endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  /* Event loop for GUI benchmarks (converter uses timers) */
+  QCoreApplication app(argc, argv);
+  /* Framesets are passed through queued connections */
+  RegisterMetaTypes();
+
+  bool list = false;
+  string filter;
+  double min_time = 1;
+  string output;
+  string baseline_file;
+  double tolerance = 0.1;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "lf:t:o:b:r:h")) != -1) {
+    switch (opt) {
+      case 'l':
+        list = true;
+        break;
+      case 'f':
+        filter = optarg;
+        break;
+      case 't':
+        min_time = std::stod(optarg);
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      case 'b':
+        baseline_file = optarg;
+        break;
+      case 'r':
+        tolerance = std::stod(optarg);
+        break;
+      default:
+        PrintUsage(argv[0]);
+        return 1;
+    }
+  }
+
+  /* Default parameters, the same for every run */
+  Parameters parameters;
+
+  bench::Runner runner(filter, min_time);
+  bench::AddTrackerBenchmarks(parameters, &runner);
+  bench::AddPipelineBenchmarks(parameters, &runner);
+  bench::AddGuiBenchmarks(parameters, &runner);
+
+  if (list) {
+    runner.List(cout);
+    return 0;
+  }
+
+  bench::Runner::ResultVector baseline;
+  if (!baseline_file.empty() &&
+      !bench::ReadJson(baseline_file, &baseline)) {
+    cerr << "Cannot read baseline '" << baseline_file << "'" << endl;
+    return 1;
+  }
+
+  runner.Run(cerr);
+
+  if (output.empty()) {
+    bench::WriteJson(runner.results(), cout);
+  } else {
+    std::ofstream file(output);
+    bench::WriteJson(runner.results(), file);
+    if (!file) {
+      cerr << "Cannot write '" << output << "'" << endl;
+      return 1;
+    }
+  }
+
+  if (!baseline_file.empty()) {
+    cerr << endl << "Comparison with " << baseline_file << ":" << endl;
+    auto regressions = bench::Compare(runner.results(), baseline, tolerance,
+                                      cerr);
+    if (regressions > 0) {
+      cerr << regressions << " regression(s)" << endl;
+      return 2;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,363 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "cases.h"
+#include "dove_eye/async_policy.h"
+#include "dove_eye/blocking_policy.h"
+#include "dove_eye/calibration_data.h"
+#include "dove_eye/constant_velocity_kalman.h"
+#include "dove_eye/cv_kalman_filter.h"
+#include "dove_eye/frame_iterator.h"
+#include "dove_eye/frameset_aggregator.h"
+#include "dove_eye/preview.h"
+
+using dove_eye::Aggregator;
+using dove_eye::AsyncPolicy;
+using dove_eye::BlockingPolicy;
+using dove_eye::CameraIndex;
+using dove_eye::CameraParameters;
+using dove_eye::ConstantVelocityKalman;
+using dove_eye::CvKalmanFilter;
+using dove_eye::FrameIterator;
+using dove_eye::Frameset;
+using dove_eye::FramesetAggregator;
+using dove_eye::FramesetPtr;
+using dove_eye::Parameters;
+using dove_eye::Point2;
+
+namespace {
+
+const CameraIndex kArity = 3;
+const double kFps = 30;
+/** Concurrent parameter readers (parameters/snapshot/readers4) */
+const size_t kReaders = 4;
+
+typedef std::function<Aggregator::ProvidersContainer()> ProvidersFactory;
+
+/** Framesets read from the aggregator
+ *
+ * When providers end, the aggregator is started over with new ones (that
+ * happens once per scene with synthetic providers, never with static ones).
+ */
+template<class Policy>
+bench::Runner::Body AggregatorBody(const Parameters &parameters,
+                                   const ProvidersFactory &create_providers) {
+  struct State {
+    State(const Parameters &parameters,
+          const ProvidersFactory &create_providers)
+        : parameters(parameters),
+          create_providers(create_providers),
+          it(kArity) {
+      Restart();
+    }
+
+    void Restart() {
+      /* Iterator refers to the aggregator, replace it first */
+      it = Aggregator::Iterator(kArity);
+      aggregator.reset(new FramesetAggregator<Policy>(create_providers(),
+                                                      parameters));
+      it = aggregator->begin();
+    }
+
+    const Parameters &parameters;
+    const ProvidersFactory create_providers;
+    std::unique_ptr<Aggregator> aggregator;
+    Aggregator::Iterator it;
+  };
+
+  auto state = std::make_shared<State>(parameters, create_providers);
+  return [state](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      ++state->it;
+      if (state->it == state->aggregator->end()) {
+        state->Restart();
+        ++state->it;
+      }
+      bench::DoNotOptimize(*state->it);
+    }
+  };
+}
+
+Aggregator::ProvidersContainer StaticProviders() {
+  const auto image = bench::TestImage(640, 480);
+  Aggregator::ProvidersContainer providers;
+  for (CameraIndex cam = 0; cam < kArity; ++cam) {
+    providers.push_back(new bench::StaticVideoProvider(image, kFps));
+  }
+  return providers;
+}
+
+bench::Runner::Body UndistortBody() {
+  auto provider = std::make_shared<bench::StaticVideoProvider>(
+      bench::TestImage(640, 480), kFps);
+  auto camera_parameters = std::make_shared<CameraParameters>();
+  camera_parameters->camera_matrix = (cv::Mat_<double>(3, 3) <<
+                                      600, 0, 320,
+                                      0, 600, 240,
+                                      0, 0, 1);
+  camera_parameters->distortion_coefficients = (cv::Mat_<double>(1, 5) <<
+                                                -0.2, 0, 0, 0, 0);
+  provider->camera_parameters(camera_parameters.get());
+  provider->undistort(true);
+
+  auto it = std::make_shared<FrameIterator>(provider->begin());
+  return [provider, camera_parameters, it](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      /* Dereference preprocesses the frame */
+      const auto frame = **it;
+      ++(*it);
+      bench::DoNotOptimize(frame);
+    }
+  };
+}
+
+/** Parameters as before snapshots, every read locks the mutex (baseline) */
+class MutexParameters {
+ public:
+  MutexParameters() {
+    Parameters defaults;
+    for (size_t key = 0; key < Parameters::_MAX_KEY; ++key) {
+      values_[key] = defaults.Get(static_cast<Parameters::Key>(key));
+    }
+  }
+
+  inline double Get(const Parameters::Key key) const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return values_[key];
+  }
+
+  bool Set(const Parameters::Key key, const double value) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    values_[key] = value;
+    return true;
+  }
+
+ private:
+  mutable std::mutex mtx_;
+  std::array<double, Parameters::_MAX_KEY> values_;
+};
+
+inline double ReadThreshold(const Parameters &parameters) {
+  const auto &snapshot = parameters.snapshot();
+  return snapshot.Get(Parameters::SEARCH_THRESHOLD);
+}
+
+inline double ReadThreshold(const MutexParameters &parameters) {
+  return parameters.Get(Parameters::SEARCH_THRESHOLD);
+}
+
+/** Parameter reads, optionally with a writer publishing every millisecond
+ *
+ * \param readers  threads reading concurrently, the measured one included
+ *                 (others read in a loop until the body is destroyed)
+ */
+template<typename ParametersType>
+bench::Runner::Body SnapshotBody(const size_t readers, const bool contended) {
+  struct State {
+    ParametersType parameters;
+    std::atomic<bool> stop;
+    std::vector<std::thread> threads;
+
+    ~State() {
+      stop = true;
+      for (auto &thread : threads) {
+        thread.join();
+      }
+    }
+  };
+
+  auto state = std::make_shared<State>();
+  state->stop = false;
+  auto raw_state = state.get();
+  if (contended) {
+    state->threads.emplace_back([raw_state] {
+      double value = 0;
+      while (!raw_state->stop) {
+        raw_state->parameters.Set(Parameters::SEARCH_THRESHOLD, value);
+        value = 0.5 - value;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+  }
+  for (size_t i = 1; i < readers; ++i) {
+    state->threads.emplace_back([raw_state] {
+      while (!raw_state->stop) {
+        bench::DoNotOptimize(ReadThreshold(raw_state->parameters));
+      }
+    });
+  }
+
+  return [state](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      bench::DoNotOptimize(ReadThreshold(state->parameters));
+    }
+  };
+}
+
+bench::Runner::Body FramesetCopyBody(const bool shared) {
+  auto scene = bench::LoopScene(kArity);
+  auto framesets = std::make_shared<bench::FramesetVector>(
+      bench::RenderFramesets(scene));
+  FramesetPtr frameset_ptr = std::make_shared<Frameset>((*framesets)[0]);
+
+  if (shared) {
+    return [frameset_ptr](const size_t iterations) {
+      for (size_t i = 0; i < iterations; ++i) {
+        FramesetPtr copy(frameset_ptr);
+        bench::DoNotOptimize(copy);
+      }
+    };
+  } else {
+    return [framesets](const size_t iterations) {
+      for (size_t i = 0; i < iterations; ++i) {
+        auto copy = (*framesets)[0];
+        bench::DoNotOptimize(copy);
+      }
+    };
+  }
+}
+
+bench::Runner::Body CvKalmanFilterBody() {
+  auto filter = std::make_shared<CvKalmanFilter>();
+  filter->Init(1e-2, 1);
+  filter->Reset();
+
+  /* Time must not go back between batches */
+  auto frame_no = std::make_shared<size_t>(0);
+  return [filter, frame_no](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      const double time = ++(*frame_no) / kFps;
+      const auto prediction = filter->Predict(time);
+      const auto deviation = filter->PredictDeviation(time);
+      const auto estimate = filter->Update(time, Point2(i % 7, i % 5));
+      bench::DoNotOptimize(prediction);
+      bench::DoNotOptimize(deviation);
+      bench::DoNotOptimize(estimate);
+    }
+  };
+}
+
+bench::Runner::Body Kalman3dBody() {
+  typedef ConstantVelocityKalman<3> Filter;
+  auto filter = std::make_shared<Filter>();
+  filter->Init(1e-4, 1e-4);
+  filter->Reset(Filter::Vector());
+
+  return [filter](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      filter->Predict();
+      filter->Correct({{1e-3f * (i % 7), 1e-3f * (i % 5), 2}});
+      bench::DoNotOptimize(*filter);
+    }
+  };
+}
+
+bench::Runner::Body DownscaleBody(const int width, const int height,
+                                  const int factor) {
+  const auto src = bench::TestImage(width, height);
+  auto dst = std::make_shared<cv::Mat>();
+
+  return [src, dst, factor](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      dove_eye::DownscaleToRgb(src, factor, dst.get());
+      bench::DoNotOptimize(*dst);
+    }
+  };
+}
+
+} // anonymous namespace
+
+namespace bench {
+
+void AddPipelineBenchmarks(const Parameters &parameters, Runner *runner) {
+  const auto params = &parameters;
+  runner->Add("aggregator/blocking/arity3", [params] {
+                return AggregatorBody<BlockingPolicy>(*params,
+                                                      StaticProviders);
+              });
+  runner->Add("aggregator/async/arity3", [params] {
+                return AggregatorBody<AsyncPolicy<false>>(*params,
+                                                          StaticProviders);
+              });
+  /*
+   * Live camera policy, producers don't wait for a full queue, they drop
+   * and retry immediately. Consumer competes with them for the queue lock.
+   */
+  runner->Add("aggregator/async/contended/arity3", [params] {
+                return AggregatorBody<AsyncPolicy<true>>(*params,
+                                                         StaticProviders);
+              });
+  /* Rendered scene, frames in pooled buffers as decoders produce them */
+  runner->Add("aggregator/blocking/synthetic/arity3", [params] {
+                auto scene = bench::LoopScene(kArity);
+                return AggregatorBody<BlockingPolicy>(*params, [scene] {
+                         return bench::SyntheticProviders(scene);
+                       });
+              });
+  runner->Add("aggregator/async/synthetic/arity3", [params] {
+                auto scene = bench::LoopScene(kArity);
+                return AggregatorBody<AsyncPolicy<false>>(*params, [scene] {
+                         return bench::SyntheticProviders(scene);
+                       });
+              });
+
+  runner->Add("provider/preprocess/undistort", [] {
+                return UndistortBody();
+              });
+
+  runner->Add("parameters/snapshot", [] {
+                return SnapshotBody<Parameters>(1, false);
+              });
+  runner->Add("parameters/snapshot/contended", [] {
+                return SnapshotBody<Parameters>(1, true);
+              });
+  runner->Add("parameters/snapshot/readers4", [] {
+                return SnapshotBody<Parameters>(kReaders, false);
+              });
+  runner->Add("parameters/snapshot/readers4/contended", [] {
+                return SnapshotBody<Parameters>(kReaders, true);
+              });
+  runner->Add("parameters/snapshot/mutex", [] {
+                return SnapshotBody<MutexParameters>(1, false);
+              });
+  runner->Add("parameters/snapshot/mutex/contended", [] {
+                return SnapshotBody<MutexParameters>(1, true);
+              });
+  runner->Add("parameters/snapshot/mutex/readers4", [] {
+                return SnapshotBody<MutexParameters>(kReaders, false);
+              });
+  runner->Add("parameters/snapshot/mutex/readers4/contended", [] {
+                return SnapshotBody<MutexParameters>(kReaders, true);
+              });
+
+  runner->Add("frameset/copy/arity3", [] {
+                return FramesetCopyBody(false);
+              });
+  runner->Add("frameset/ptr/arity3", [] {
+                return FramesetCopyBody(true);
+              });
+
+  runner->Add("kalman/cv_kalman_filter", [] {
+                return CvKalmanFilterBody();
+              });
+  runner->Add("kalman/constant_velocity_3d", [] {
+                return Kalman3dBody();
+              });
+
+  runner->Add("preview/downscale/640x480", [] {
+                return DownscaleBody(640, 480, 2);
+              });
+  runner->Add("preview/downscale/1920x1080", [] {
+                return DownscaleBody(1920, 1080, 4);
+              });
+}
+
+} // namespace bench
@@ -0,0 +1,20 @@
+#include "receiver.h"
+
+#include "bench.h"
+
+using dove_eye::CameraIndex;
+
+namespace bench {
+
+void FramesetReceiver::ReceiveFrameset(const dove_eye::Frameset &frameset) {
+  for (CameraIndex cam = 0; cam < frameset.Arity(); ++cam) {
+    DoNotOptimize(frameset[cam].data.data);
+  }
+}
+
+void FramesetReceiver::ReceiveFramesetPtr(
+    const dove_eye::FramesetPtr frameset) {
+  ReceiveFrameset(*frameset);
+}
+
+} // namespace bench
@@ -0,0 +1,23 @@
+#ifndef DOVE_EYE_BENCH_RECEIVER_H_
+#define DOVE_EYE_BENCH_RECEIVER_H_
+
+#include <QObject>
+
+#include "dove_eye/frameset.h"
+
+namespace bench {
+
+/** Slots for queued connection benchmarks, framesets are only touched */
+class FramesetReceiver : public QObject {
+  Q_OBJECT
+
+ public slots:
+  /** Frameset by value, as FramesetReady used to pass it */
+  void ReceiveFrameset(const dove_eye::Frameset &frameset);
+
+  void ReceiveFramesetPtr(const dove_eye::FramesetPtr frameset);
+};
+
+} // namespace bench
+
+#endif // DOVE_EYE_BENCH_RECEIVER_H_
@@ -0,0 +1,224 @@
+#include <memory>
+#include <string>
+
+#include "cases.h"
+#include "common/trackers.h"
+#include "dove_eye/circle_tracker.h"
+#include "dove_eye/histogram_tracker.h"
+#include "dove_eye/klt_tracker.h"
+#include "dove_eye/localization.h"
+#include "dove_eye/mosse_tracker.h"
+#include "dove_eye/template_tracker.h"
+#include "dove_eye/tld_tracker.h"
+#include "dove_eye/tracker.h"
+
+using dove_eye::CameraIndex;
+using dove_eye::CircleTracker;
+using dove_eye::HistogramTracker;
+using dove_eye::InnerTracker;
+using dove_eye::KltTracker;
+using dove_eye::Localization;
+using dove_eye::Location;
+using dove_eye::MosseTracker;
+using dove_eye::Parameters;
+using dove_eye::Posit;
+using dove_eye::TemplateTracker;
+using dove_eye::TldTracker;
+using dove_eye::Tracker;
+using std::string;
+
+namespace {
+
+const CameraIndex kArity = 3;
+
+/** Makes protected search interface of a SearchingTracker accessible */
+template<class T>
+class Exposed : public T {
+ public:
+  explicit Exposed(const Parameters &parameters)
+      : T(parameters) {
+  }
+
+  using T::DataToRoi;
+  using T::InitTrackerData;
+  using T::Search;
+};
+
+/** KLT tracker with the template fallback, constructible from parameters */
+class TemplateKltTracker : public KltTracker {
+ public:
+  explicit TemplateKltTracker(const Parameters &parameters)
+      : KltTracker(parameters, TemplateTracker(parameters)) {
+  }
+};
+
+/** Mark around the object as seen by the camera at the time */
+InnerTracker::Mark SceneMark(const bench::ScenePtr &scene,
+                             const CameraIndex cam,
+                             const dove_eye::Frame::Timestamp time,
+                             const InnerTracker::Mark::Type type,
+                             Posit *posit) {
+  double radius;
+  (void)scene->PositAt(cam, time, posit, &radius);
+  return common::MarkAt(type, *posit, radius);
+}
+
+/** Search of the object in ROI of size factor (0 for whole frame) */
+template<class T>
+bench::Runner::Body SearchBody(const Parameters &parameters,
+                               const double factor) {
+  auto scene = bench::LoopScene(1);
+  auto framesets = std::make_shared<bench::FramesetVector>(
+      bench::RenderFramesets(scene));
+
+  auto tracker = std::make_shared<Exposed<T>>(parameters);
+  const auto &frame = (*framesets)[0][0];
+  Posit posit;
+  (void)tracker->InitTrackerData(
+      frame.data, SceneMark(scene, 0, frame.timestamp,
+                            tracker->PreferredMarkType(), &posit));
+
+  /* Search in the next frame (object moved) */
+  const auto &next = (*framesets)[1][0];
+  (void)scene->PositAt(0, next.timestamp, &posit);
+  const auto roi = tracker->DataToRoi(tracker->tracker_data(), posit, factor);
+
+  return [framesets, tracker, factor, roi](const size_t iterations) {
+    const auto &data = (*framesets)[1][0].data;
+    InnerTracker::Mark result(InnerTracker::Mark::kInvalid);
+    for (size_t i = 0; i < iterations; ++i) {
+      /* Zero threshold, any match is accepted */
+      tracker->Search(data, tracker->tracker_data(),
+                      (factor > 0) ? &roi : nullptr, nullptr, 0, &result);
+      bench::DoNotOptimize(result);
+    }
+  };
+}
+
+template<class T>
+void AddSearchBenchmarks(const Parameters &parameters, const string &name,
+                         bench::Runner *runner) {
+  const auto params = &parameters;
+  for (auto factor : {2, 4, 8}) {
+    runner->Add("search/" + name + "/roi" + std::to_string(factor),
+                [params, factor] {
+                  return SearchBody<T>(*params, factor);
+                });
+  }
+  runner->Add("search/" + name + "/frame", [params] {
+                return SearchBody<T>(*params, 0);
+              });
+}
+
+/** Tracking of consecutive frames of the loop scene, per frame */
+bench::Runner::Body TldTrackBody(const Parameters &parameters) {
+  auto scene = bench::LoopScene(1);
+  auto framesets = std::make_shared<bench::FramesetVector>(
+      bench::RenderFramesets(scene));
+
+  auto tracker = std::make_shared<TldTracker>(parameters);
+  const auto &frame = (*framesets)[0][0];
+  Posit posit;
+  (void)tracker->InitializeTracking(
+      frame, SceneMark(scene, 0, frame.timestamp,
+                       tracker->PreferredMarkType(), &posit), &posit);
+
+  auto frame_no = std::make_shared<size_t>(1);
+  return [framesets, tracker, frame_no](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      const auto &current = (*framesets)[*frame_no][0];
+      *frame_no = (*frame_no + 1) % framesets->size();
+
+      Posit result;
+      if (!tracker->Track(current, &result)) {
+        (void)tracker->ReinitializeTracking(current, &result);
+      }
+      bench::DoNotOptimize(result);
+    }
+  };
+}
+
+/** Tracker::Track on consecutive framesets of the loop scene */
+template<class T>
+bench::Runner::Body TrackerBody(const Parameters &parameters,
+                                const bool fused) {
+  auto scene = bench::LoopScene(kArity);
+  auto framesets = std::make_shared<bench::FramesetVector>(
+      bench::RenderFramesets(scene));
+
+  T inner_tracker(parameters);
+  auto tracker = std::make_shared<Tracker>(parameters, kArity, inner_tracker);
+  tracker->calibration_data(&scene->calibration_data());
+  tracker->fused(fused);
+
+  const auto &frameset = (*framesets)[0];
+  for (CameraIndex cam = 0; cam < kArity; ++cam) {
+    Posit posit;
+    const auto mark = SceneMark(scene, cam, frameset[cam].timestamp,
+                                inner_tracker.PreferredMarkType(), &posit);
+    (void)tracker->SetMark(frameset, cam, mark);
+  }
+
+  /* Tracker refers to calibration data of the scene */
+  auto frame_no = std::make_shared<size_t>(1);
+  return [scene, framesets, tracker, frame_no](const size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+      const auto &result = tracker->Track((*framesets)[*frame_no]);
+      *frame_no = (*frame_no + 1) % framesets->size();
+      bench::DoNotOptimize(result);
+    }
+  };
+}
+
+bench::Runner::Body LocateBody() {
+  auto scene = bench::LoopScene(kArity);
+  auto localization = std::make_shared<Localization>(kArity);
+  localization->calibration_data(&scene->calibration_data());
+  const auto positset = scene->PositsetAt(0.5);
+
+  return [scene, localization, positset](const size_t iterations) {
+    Location location;
+    for (size_t i = 0; i < iterations; ++i) {
+      (void)localization->Locate(positset, &location);
+      bench::DoNotOptimize(location);
+    }
+  };
+}
+
+} // anonymous namespace
+
+namespace bench {
+
+void AddTrackerBenchmarks(const Parameters &parameters, Runner *runner) {
+  AddSearchBenchmarks<TemplateTracker>(parameters, "template", runner);
+  AddSearchBenchmarks<HistogramTracker>(parameters, "histogram", runner);
+  AddSearchBenchmarks<CircleTracker>(parameters, "circle", runner);
+  AddSearchBenchmarks<MosseTracker>(parameters, "mosse", runner);
+
+  const auto params = &parameters;
+  runner->Add("track/tld", [params] {
+                return TldTrackBody(*params);
+              });
+
+  runner->Add("tracker/track/template", [params] {
+                return TrackerBody<TemplateTracker>(*params, false);
+              });
+  runner->Add("tracker/track_fused/template", [params] {
+                return TrackerBody<TemplateTracker>(*params, true);
+              });
+  runner->Add("tracker/track/histogram", [params] {
+                return TrackerBody<HistogramTracker>(*params, false);
+              });
+  runner->Add("tracker/track/mosse", [params] {
+                return TrackerBody<MosseTracker>(*params, false);
+              });
+  runner->Add("tracker/track/klt", [params] {
+                return TrackerBody<TemplateKltTracker>(*params, false);
+              });
+
+  runner->Add("localization/locate", [] {
+                return LocateBody();
+              });
+}
+
+} // namespace bench
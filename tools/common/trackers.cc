@@ -0,0 +1,47 @@
+#include "common/trackers.h"
+
+#include "dove_eye/circle_tracker.h"
+#include "dove_eye/histogram_tracker.h"
+#include "dove_eye/klt_tracker.h"
+#include "dove_eye/mosse_tracker.h"
+#include "dove_eye/template_tracker.h"
+#include "dove_eye/tld_tracker.h"
+
+using dove_eye::InnerTracker;
+using dove_eye::Parameters;
+using dove_eye::Posit;
+using std::string;
+
+namespace common {
+
+InnerTrackerPtr CreateTracker(const Parameters &parameters,
+                              const string &name) {
+  if (name == "template") {
+    return InnerTrackerPtr(new dove_eye::TemplateTracker(parameters));
+  } else if (name == "histogram") {
+    return InnerTrackerPtr(new dove_eye::HistogramTracker(parameters));
+  } else if (name == "circle") {
+    return InnerTrackerPtr(new dove_eye::CircleTracker(parameters));
+  } else if (name == "tld") {
+    return InnerTrackerPtr(new dove_eye::TldTracker(parameters));
+  } else if (name == "mosse") {
+    return InnerTrackerPtr(new dove_eye::MosseTracker(parameters));
+  } else if (name == "klt") {
+    dove_eye::TemplateTracker fallback(parameters);
+    return InnerTrackerPtr(new dove_eye::KltTracker(parameters, fallback));
+  }
+  return nullptr;
+}
+
+InnerTracker::Mark MarkAt(const InnerTracker::Mark::Type type,
+                          const Posit posit,
+                          const double radius) {
+  InnerTracker::Mark mark(type);
+  mark.center = posit;
+  mark.radius = radius;
+  mark.top_left = posit - Posit(radius, radius);
+  mark.size = Posit(2 * radius, 2 * radius);
+  return mark;
+}
+
+} // namespace common
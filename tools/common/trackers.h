@@ -0,0 +1,38 @@
+#ifndef DOVE_EYE_COMMON_TRACKERS_H_
+#define DOVE_EYE_COMMON_TRACKERS_H_
+
+#include <memory>
+#include <string>
+
+#include "dove_eye/inner_tracker.h"
+#include "dove_eye/parameters.h"
+#include "dove_eye/types.h"
+
+/** Helpers shared by command line tools (bench, evaluate, replay) */
+namespace common {
+
+typedef std::unique_ptr<dove_eye::InnerTracker> InnerTrackerPtr;
+
+/** Inner tracker by its name
+ *
+ * Names: template, histogram, circle, mosse, klt (with template fallback),
+ * tld.
+ * @return  nullptr for unknown name
+ */
+InnerTrackerPtr CreateTracker(const dove_eye::Parameters &parameters,
+                              const std::string &name);
+
+/** Mark of the object centered at posit
+ *
+ * Both circle and rectangle are filled, type decides which is used.
+ *
+ * \param radius  apparent radius of the object (px)
+ */
+dove_eye::InnerTracker::Mark MarkAt(
+    const dove_eye::InnerTracker::Mark::Type type,
+    const dove_eye::Posit posit,
+    const double radius);
+
+} // namespace common
+
+#endif // DOVE_EYE_COMMON_TRACKERS_H_
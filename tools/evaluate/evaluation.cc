@@ -0,0 +1,187 @@
+#include "evaluation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+
+#include <opencv2/opencv.hpp>
+
+#include "common/trackers.h"
+#include "dove_eye/localization.h"
+
+using dove_eye::CameraIndex;
+using dove_eye::Frameset;
+using dove_eye::InnerTracker;
+using dove_eye::Localization;
+using dove_eye::Location;
+using dove_eye::Parameters;
+using dove_eye::Positset;
+using dove_eye::Tracker;
+using std::setw;
+using std::string;
+
+namespace {
+
+double Ratio(const size_t part, const size_t whole) {
+  return (whole > 0) ? static_cast<double>(part) / whole : 0;
+}
+
+} // anonymous namespace
+
+namespace evaluate {
+
+double ErrorStatistics::Mean() const {
+  if (errors_.empty()) {
+    return 0;
+  }
+
+  double sum = 0;
+  for (auto error : errors_) {
+    sum += error;
+  }
+  return sum / errors_.size();
+}
+
+double ErrorStatistics::Percentile(const double p) const {
+  if (errors_.empty()) {
+    return 0;
+  }
+
+  std::sort(errors_.begin(), errors_.end());
+  const size_t index = std::min(errors_.size() - 1,
+                                static_cast<size_t>(p * errors_.size()));
+  return errors_[index];
+}
+
+
+Result Evaluate(const Parameters &parameters,
+                const string &name,
+                const InnerTracker &inner_tracker,
+                const bool fused,
+                Sequence *sequence) {
+  const auto arity = sequence->Arity();
+  const auto calibration_data = sequence->calibration_data();
+
+  Result result;
+  result.tracker = name + (fused ? " (fused)" : "");
+  result.sequence = sequence->Name();
+  result.cameras.resize(arity);
+
+  Tracker tracker(parameters, arity, inner_tracker);
+  Localization localization(arity);
+  if (calibration_data) {
+    tracker.calibration_data(calibration_data);
+    tracker.fused(fused);
+    localization.calibration_data(calibration_data);
+  }
+
+  std::vector<bool> marked(arity, false);
+
+  sequence->Rewind();
+  Frameset frameset;
+  Positset truth;
+  Location true_location;
+  bool has_location;
+  while (sequence->Next(&frameset, &truth, &true_location, &has_location)) {
+    /* Cameras that see the object for the first time get a mark */
+    for (CameraIndex cam = 0; cam < arity; ++cam) {
+      if (!marked[cam] && frameset.IsValid(cam) && truth.IsValid(cam)) {
+        /* Mark as the user would draw it, around the visible object */
+        double radius;
+        if (!sequence->ObjectRadius(cam, &radius)) {
+          radius = parameters.Get(Parameters::TEMPLATE_RADIUS);
+        }
+        auto mark = common::MarkAt(inner_tracker.PreferredMarkType(),
+                                   truth[cam], radius);
+        (void)tracker.SetMark(frameset, cam, mark);
+        marked[cam] = true;
+      }
+    }
+
+    const auto &positset = tracker.Track(frameset);
+
+    for (CameraIndex cam = 0; cam < arity; ++cam) {
+      auto &camera = result.cameras[cam];
+      if (truth.IsValid(cam)) {
+        camera.visible += 1;
+        if (positset.IsValid(cam)) {
+          camera.error.Add(cv::norm(positset[cam] - truth[cam]));
+        }
+      } else if (positset.IsValid(cam)) {
+        camera.false_positives += 1;
+      }
+    }
+
+    if (!calibration_data) {
+      continue;
+    }
+
+    Location location;
+    const bool located = localization.Locate(positset, &location);
+    if (located && !fused) {
+      (void)tracker.SetLocation(location);
+    }
+
+    if (has_location) {
+      result.locatable += 1;
+      if (located) {
+        result.located += 1;
+        result.location_error.Add(cv::norm(location - true_location));
+      }
+    }
+  }
+
+  for (CameraIndex cam = 0; cam < arity; ++cam) {
+    result.cameras[cam].statistics = tracker.statistics(cam);
+  }
+
+  return result;
+}
+
+void PrintTable(const ResultVector &results, std::ostream &out) {
+  out << std::left << setw(20) << "tracker" << setw(24) << "sequence"
+      << std::right << setw(4) << "cam" << setw(8) << "visible"
+      << setw(9) << "found %" << setw(10) << "ms/frame"
+      << setw(8) << "losses" << setw(12) << "reacq p/e/g"
+      << setw(8) << "false+" << setw(10) << "err mean" << setw(10) << "err p95"
+      << std::endl;
+
+  out << std::fixed << std::setprecision(2);
+  for (auto &result : results) {
+    for (size_t cam = 0; cam < result.cameras.size(); ++cam) {
+      auto &camera = result.cameras[cam];
+      auto &statistics = camera.statistics;
+      const std::chrono::duration<double, std::milli> time = statistics.time;
+      const auto reacquisitions =
+          std::to_string(statistics.found_projection) + "/" +
+          std::to_string(statistics.found_epiline) + "/" +
+          std::to_string(statistics.found_global);
+
+      out << std::left << setw(20) << result.tracker
+          << setw(24) << result.sequence
+          << std::right << setw(4) << cam << setw(8) << camera.visible
+          << setw(9) << 100 * Ratio(camera.error.Count(), camera.visible)
+          << setw(10) << time.count() / std::max<size_t>(1, statistics.frames)
+          << setw(8) << statistics.losses << setw(12) << reacquisitions
+          << setw(8) << camera.false_positives
+          << setw(10) << camera.error.Mean()
+          << setw(10) << camera.error.Percentile(0.95) << std::endl;
+    }
+
+    /* Localization errors are in millimeters */
+    if (result.locatable > 0) {
+      out << std::left << setw(20) << result.tracker
+          << setw(24) << result.sequence
+          << std::right << setw(4) << "3D" << setw(8) << result.locatable
+          << setw(9) << 100 * Ratio(result.located, result.locatable)
+          << setw(10) << "" << setw(8) << "" << setw(12) << "" << setw(8) << ""
+          << setw(10) << 1000 * result.location_error.Mean()
+          << setw(10) << 1000 * result.location_error.Percentile(0.95)
+          << std::endl;
+    }
+  }
+}
+
+} // namespace evaluate
@@ -0,0 +1,87 @@
+#ifndef DOVE_EYE_EVALUATE_EVALUATION_H_
+#define DOVE_EYE_EVALUATE_EVALUATION_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "dove_eye/inner_tracker.h"
+#include "dove_eye/parameters.h"
+#include "dove_eye/tracker.h"
+#include "sequence.h"
+
+namespace evaluate {
+
+/** Distribution of errors (px or m) */
+class ErrorStatistics {
+ public:
+  void Add(const double error) {
+    errors_.push_back(error);
+  }
+
+  inline size_t Count() const {
+    return errors_.size();
+  }
+
+  double Mean() const;
+
+  /** \param p  0..1 */
+  double Percentile(const double p) const;
+
+ private:
+  /* Sorted lazily */
+  mutable std::vector<double> errors_;
+};
+
+struct CameraResult {
+  dove_eye::Tracker::Statistics statistics;
+  /** Frames where the object is visible (ground truth valid) */
+  size_t visible;
+  /** Valid posits without visible object */
+  size_t false_positives;
+  ErrorStatistics error;
+
+  CameraResult()
+      : visible(0),
+        false_positives(0) {
+  }
+};
+
+struct Result {
+  std::string tracker;
+  std::string sequence;
+  std::vector<CameraResult> cameras;
+
+  /** Framesets with ground truth location */
+  size_t locatable;
+  /** ... and with location from tracked posits */
+  size_t located;
+  ErrorStatistics location_error;
+
+  Result()
+      : locatable(0),
+        located(0) {
+  }
+};
+
+typedef std::vector<Result> ResultVector;
+
+/** Replay sequence through Tracker with the inner tracker
+ *
+ * Tracking of each camera is initialized by a mark at ground truth in the
+ * first frame the object is visible. Localization (when the sequence is
+ * calibrated) re-initializes lost trackers, like in the application.
+ *
+ * \param fused  tracking in fused 3D mode (calibrated sequences only)
+ */
+Result Evaluate(const dove_eye::Parameters &parameters,
+                const std::string &name,
+                const dove_eye::InnerTracker &inner_tracker,
+                const bool fused,
+                Sequence *sequence);
+
+void PrintTable(const ResultVector &results, std::ostream &out);
+
+} // namespace evaluate
+
+#endif // DOVE_EYE_EVALUATE_EVALUATION_H_
@@ -0,0 +1,189 @@
+/** Accuracy and cost of inner trackers on sequences with ground truth
+ *
+ * Every selected tracker is run on every sequence, results are printed in
+ * a single table: time per frame and camera, losses and re-acquisitions
+ * (from projected location/epiline/global search), 2D error against ground
+ * truth (px) and error of location triangulated from tracked posits (mm).
+ *
+ * Sequences are either synthetic scenarios (-s) or video files with
+ * annotation (-v for each camera, -g annotation, -c calibration). Parameters
+ * can be loaded from a file saved by the application (-p), so that they can
+ * be tuned on the same footage.
+ */
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <QString>
+#include <unistd.h>
+
+#include "common/trackers.h"
+#include "dove_eye/calibration_data.h"
+#include "dove_eye/parameters.h"
+#include "evaluation.h"
+#include "io/calibration_data_storage.h"
+#include "io/parameters_storage.h"
+#include "sequence.h"
+
+using dove_eye::CalibrationData;
+using dove_eye::CameraIndex;
+using dove_eye::Parameters;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+namespace {
+
+
+vector<string> Split(const string &list) {
+  vector<string> result;
+  std::istringstream input(list);
+  string item;
+  while (std::getline(input, item, ',')) {
+    result.push_back(item);
+  }
+  return result;
+}
+
+void PrintUsage(const string &name) {
+  cout << "Usage: " << name << " [-t trackers] [-s scenarios] [-a arity]"
+      " [-d duration] [-v video -v video ... -g annotation [-c calibration]]"
+      " [-p parameters] [-f]" << endl;
+  cout << "  -t  comma separated trackers (default template,histogram,"
+      "circle,mosse,klt,tld)" << endl;
+  cout << "  -s  comma separated synthetic scenarios (default loop,occluded,"
+      " also fast, patch)" << endl;
+  cout << "  -a  number of cameras of synthetic scenarios (default 3)" << endl;
+  cout << "  -d  duration of synthetic scenarios [s] (default 4)" << endl;
+  cout << "  -v  video file of the next camera" << endl;
+  cout << "  -g  annotation of the videos (lines 'frameset cam x y')" << endl;
+  cout << "  -c  calibration data of the videos" << endl;
+  cout << "  -p  parameters file" << endl;
+  cout << "  -f  evaluate fused tracking too" << endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  string trackers = "template,histogram,circle,mosse,klt,tld";
+  string scenarios;
+  CameraIndex arity = 3;
+  double duration = 4;
+  vector<string> videos;
+  string annotation;
+  string calibration_file;
+  string parameters_file;
+  bool fused = false;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "t:s:a:d:v:g:c:p:fh")) != -1) {
+    switch (opt) {
+      case 't':
+        trackers = optarg;
+        break;
+      case 's':
+        scenarios = optarg;
+        break;
+      case 'a':
+        arity = std::stoi(optarg);
+        break;
+      case 'd':
+        duration = std::stod(optarg);
+        break;
+      case 'v':
+        videos.push_back(optarg);
+        break;
+      case 'g':
+        annotation = optarg;
+        break;
+      case 'c':
+        calibration_file = optarg;
+        break;
+      case 'p':
+        parameters_file = optarg;
+        break;
+      case 'f':
+        fused = true;
+        break;
+      default:
+        PrintUsage(argv[0]);
+        return 1;
+    }
+  }
+
+  if (videos.empty() != annotation.empty()) {
+    cerr << "Videos and annotation must be given together" << endl;
+    return 1;
+  }
+  if (scenarios.empty() && videos.empty()) {
+    scenarios = "loop,occluded";
+  }
+
+  Parameters parameters;
+  if (!parameters_file.empty()) {
+    io::ParametersStorage storage(parameters);
+    storage.LoadFromFile(QString::fromStdString(parameters_file));
+  }
+
+  vector<evaluate::SequencePtr> sequences;
+  for (auto &scenario : Split(scenarios)) {
+    if (!evaluate::SyntheticSequence::IsScenario(scenario)) {
+      cerr << "Unknown scenario '" << scenario << "'" << endl;
+      return 1;
+    }
+    sequences.emplace_back(new evaluate::SyntheticSequence(
+            parameters, scenario, arity, duration));
+  }
+
+  std::unique_ptr<CalibrationData> calibration_data;
+  if (!calibration_file.empty()) {
+    io::CalibrationDataStorage storage;
+    calibration_data.reset(new CalibrationData(
+            storage.LoadFromFile(QString::fromStdString(calibration_file))));
+    if (calibration_data->Arity() != static_cast<CameraIndex>(videos.size())) {
+      cerr << "Calibration doesn't match number of videos" << endl;
+      return 1;
+    }
+  }
+
+  if (!videos.empty()) {
+    auto sequence = new evaluate::AnnotatedSequence(parameters, videos,
+                                                    annotation,
+                                                    calibration_data.get());
+    sequences.emplace_back(sequence);
+    if (!sequence->IsValid()) {
+      return 1;
+    }
+  }
+
+  evaluate::ResultVector results;
+  for (auto &name : Split(trackers)) {
+    auto inner_tracker = common::CreateTracker(parameters, name);
+    if (!inner_tracker) {
+      cerr << "Unknown tracker '" << name << "'" << endl;
+      return 1;
+    }
+
+    for (auto &sequence : sequences) {
+      cerr << "Evaluating " << name << " on " << sequence->Name() << endl;
+      results.push_back(evaluate::Evaluate(parameters, name, *inner_tracker,
+                                           false, sequence.get()));
+
+      if (fused && sequence->calibration_data()) {
+        results.push_back(evaluate::Evaluate(parameters, name,
+                                             *inner_tracker, true,
+                                             sequence.get()));
+      }
+    }
+  }
+
+  evaluate::PrintTable(results, cout);
+
+  return 0;
+}
@@ -0,0 +1,251 @@
+#include "sequence.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include "dove_eye/blocking_policy.h"
+#include "dove_eye/file_video_provider.h"
+#include "dove_eye/frameset_aggregator.h"
+#include "dove_eye/localization.h"
+#include "dove_eye/logging.h"
+#include "dove_eye/synthetic_video_provider.h"
+
+using dove_eye::Aggregator;
+using dove_eye::BlockingPolicy;
+using dove_eye::CalibrationData;
+using dove_eye::CameraIndex;
+using dove_eye::FileVideoProvider;
+using dove_eye::Frameset;
+using dove_eye::FramesetAggregator;
+using dove_eye::Localization;
+using dove_eye::Location;
+using dove_eye::Parameters;
+using dove_eye::Posit;
+using dove_eye::Positset;
+using dove_eye::SyntheticScene;
+using dove_eye::SyntheticVideoProvider;
+using std::string;
+
+namespace {
+
+/** Horizontal circle around the point the rig is looking at */
+SyntheticScene::Trajectory Circle(const double radius, const double period,
+                                  const double duration) {
+  const int kWaypointsPerPeriod = 16;
+  const double kDistance = 2;
+
+  const int waypoints = std::ceil(duration / period * kWaypointsPerPeriod);
+  SyntheticScene::Trajectory result;
+  for (int i = 0; i <= waypoints; ++i) {
+    const double time = period * i / kWaypointsPerPeriod;
+    const double angle = 2 * M_PI * time / period;
+    result.push_back({time,
+                      Location(radius * std::cos(angle), 0,
+                               kDistance + radius * std::sin(angle))});
+  }
+
+  return result;
+}
+
+} // anonymous namespace
+
+namespace evaluate {
+
+SyntheticSequence::SyntheticSequence(const Parameters &parameters,
+                                     const string &scenario,
+                                     const CameraIndex arity,
+                                     const double duration)
+    : parameters_(parameters),
+      scenario_(scenario),
+      it_(arity),
+      scene_times_(arity, 0) {
+  assert(IsScenario(scenario));
+
+  SyntheticScene::Settings settings;
+  SyntheticScene::OcclusionVector occlusions;
+  double radius = 0.2;
+  double period = 2;
+
+  if (scenario == "fast") {
+    radius = 0.3;
+    period = 1;
+  } else if (scenario == "occluded") {
+    /* Each camera in turn, so that others can help with re-acquisition */
+    const double length = duration / (arity + 1);
+    for (CameraIndex cam = 0; cam < arity; ++cam) {
+      occlusions.push_back({cam, (cam + 0.5) * length, (cam + 1) * length});
+    }
+  } else if (scenario == "patch") {
+    settings.object_type = SyntheticScene::kPatch;
+  }
+
+  auto calibration_data = SyntheticScene::CreateRig(arity, settings.width,
+                                                    settings.height);
+  scene_.reset(new SyntheticScene(calibration_data,
+                                  Circle(radius, period, duration),
+                                  settings, occlusions));
+  Rewind();
+}
+
+bool SyntheticSequence::IsScenario(const string &scenario) {
+  return scenario == "loop" || scenario == "fast" ||
+      scenario == "occluded" || scenario == "patch";
+}
+
+void SyntheticSequence::Rewind() {
+  Aggregator::ProvidersContainer providers;
+  for (CameraIndex cam = 0; cam < Arity(); ++cam) {
+    providers.push_back(new SyntheticVideoProvider(scene_, cam));
+  }
+
+  /* Iterator refers to the aggregator, replace it first */
+  it_ = Aggregator::Iterator(Arity());
+  aggregator_.reset(new FramesetAggregator<BlockingPolicy>(providers,
+                                                           parameters_));
+  it_ = aggregator_->begin();
+  std::fill(scene_times_.begin(), scene_times_.end(), 0);
+}
+
+bool SyntheticSequence::Next(Frameset *frameset, Positset *truth,
+                             Location *location, bool *has_location) {
+  /* Begin iterator doesn't point to a frameset yet */
+  ++it_;
+  if (it_ == aggregator_->end()) {
+    return false;
+  }
+
+  *frameset = *it_;
+
+  /* Ground truth at capture time (aggregator subtracted the offset) */
+  *truth = Positset(Arity());
+  *has_location = false;
+  for (CameraIndex cam = 0; cam < Arity(); ++cam) {
+    if (!frameset->IsValid(cam)) {
+      continue;
+    }
+
+    const auto time = (*frameset)[cam].timestamp +
+        parameters_.Get(Parameters::CAM_OFFSET, cam);
+    scene_times_[cam] = time;
+    truth->SetValid(cam, scene_->PositAt(cam, time, &(*truth)[cam]));
+
+    if (!*has_location) {
+      *location = scene_->LocationAt(time);
+      *has_location = true;
+    }
+  }
+
+  return true;
+}
+
+bool SyntheticSequence::ObjectRadius(const CameraIndex cam,
+                                     double *radius) const {
+  if (scene_times_[cam] == 0) {
+    return false;
+  }
+
+  Posit posit;
+  (void)scene_->PositAt(cam, scene_times_[cam], &posit, radius);
+  return true;
+}
+
+
+AnnotatedSequence::AnnotatedSequence(
+    const Parameters &parameters,
+    const FilenameVector &videos,
+    const string &annotation,
+    const CalibrationData *calibration_data)
+    : parameters_(parameters),
+      videos_(videos),
+      annotation_(annotation),
+      calibration_data_(calibration_data),
+      it_(static_cast<CameraIndex>(videos_.size())),
+      frameset_no_(0) {
+  valid_ = ReadAnnotation();
+  if (valid_) {
+    Rewind();
+  }
+}
+
+void AnnotatedSequence::Rewind() {
+  Aggregator::ProvidersContainer providers;
+  for (auto &video : videos_) {
+    providers.push_back(new FileVideoProvider(video));
+  }
+
+  /* Iterator refers to the aggregator, replace it first */
+  it_ = Aggregator::Iterator(Arity());
+  aggregator_.reset(new FramesetAggregator<BlockingPolicy>(providers,
+                                                           parameters_));
+  it_ = aggregator_->begin();
+  frameset_no_ = 0;
+}
+
+bool AnnotatedSequence::Next(Frameset *frameset, Positset *truth,
+                             Location *location, bool *has_location) {
+  /* Begin iterator doesn't point to a frameset yet */
+  ++it_;
+  if (it_ == aggregator_->end()) {
+    return false;
+  }
+
+  *frameset = *it_;
+
+  auto annotation = annotations_.find(frameset_no_);
+  if (annotation != annotations_.end()) {
+    *truth = annotation->second;
+  } else {
+    *truth = Positset(Arity());
+  }
+
+  *has_location = false;
+  if (calibration_data_) {
+    Localization localization(Arity());
+    localization.calibration_data(calibration_data_);
+    *has_location = localization.Locate(*truth, location);
+  }
+
+  ++frameset_no_;
+  return true;
+}
+
+bool AnnotatedSequence::ReadAnnotation() {
+  std::ifstream file(annotation_);
+  if (!file) {
+    ERROR("Cannot open annotation '%s'", annotation_.c_str());
+    return false;
+  }
+
+  string line;
+  size_t line_no = 0;
+  while (std::getline(file, line)) {
+    ++line_no;
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    std::istringstream input(line);
+    size_t frameset_no;
+    CameraIndex cam;
+    Posit posit;
+    if (!(input >> frameset_no >> cam >> posit.x >> posit.y) ||
+        cam < 0 || cam >= Arity()) {
+      ERROR("Invalid annotation '%s' on line %zu", annotation_.c_str(),
+            line_no);
+      return false;
+    }
+
+    auto it = annotations_.find(frameset_no);
+    if (it == annotations_.end()) {
+      it = annotations_.insert({frameset_no, Positset(Arity())}).first;
+    }
+    it->second[cam] = posit;
+    it->second.SetValid(cam, true);
+  }
+
+  return true;
+}
+
+} // namespace evaluate
@@ -0,0 +1,178 @@
+#ifndef DOVE_EYE_EVALUATE_SEQUENCE_H_
+#define DOVE_EYE_EVALUATE_SEQUENCE_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dove_eye/aggregator.h"
+#include "dove_eye/calibration_data.h"
+#include "dove_eye/frameset.h"
+#include "dove_eye/location.h"
+#include "dove_eye/parameters.h"
+#include "dove_eye/positset.h"
+#include "dove_eye/synthetic_scene.h"
+
+namespace evaluate {
+
+/** Multi-camera sequence of framesets with ground truth
+ *
+ * Sequence is read from the beginning by repeated Next() calls, Rewind()
+ * starts it over (for evaluation of another tracker).
+ */
+class Sequence {
+ public:
+  virtual ~Sequence() {}
+
+  virtual std::string Name() const = 0;
+
+  virtual dove_eye::CameraIndex Arity() const = 0;
+
+  /** Calibration of cameras, nullptr when not available */
+  virtual const dove_eye::CalibrationData *calibration_data() const = 0;
+
+  virtual void Rewind() = 0;
+
+  /** Next frameset and its ground truth
+   *
+   * Ground truth posit is valid only where the object is visible and
+   * annotated.
+   *
+   * \param location  ground truth location (valid when it returns true)
+   * \return          false at the end of sequence
+   */
+  virtual bool Next(dove_eye::Frameset *frameset, dove_eye::Positset *truth,
+                    dove_eye::Location *location, bool *has_location) = 0;
+
+  /** Apparent radius of the object in the last frameset returned by Next()
+   *
+   * @return  false when it's not known
+   */
+  virtual bool ObjectRadius(const dove_eye::CameraIndex cam,
+                            double *radius) const {
+    return false;
+  }
+};
+
+typedef std::unique_ptr<Sequence> SequencePtr;
+
+
+/** Sequence rendered from SyntheticScene on the fly
+ *
+ * Frames are read through SyntheticVideoProvider and aggregated like those
+ * of live cameras (the last frames, still in the aggregation window, are
+ * not delivered).
+ *
+ * Scenarios:
+ *   loop      ball on a slow horizontal circle
+ *   fast      ball on a larger circle, twice as fast
+ *   occluded  loop, cameras are occluded one after another
+ *   patch     loop with textured square instead of ball
+ */
+class SyntheticSequence : public Sequence {
+ public:
+  SyntheticSequence(const dove_eye::Parameters &parameters,
+                    const std::string &scenario,
+                    const dove_eye::CameraIndex arity,
+                    const double duration);
+
+  static bool IsScenario(const std::string &scenario);
+
+  std::string Name() const override {
+    return "synthetic:" + scenario_;
+  }
+
+  dove_eye::CameraIndex Arity() const override {
+    return scene_->Arity();
+  }
+
+  const dove_eye::CalibrationData *calibration_data() const override {
+    return &scene_->calibration_data();
+  }
+
+  void Rewind() override;
+
+  bool Next(dove_eye::Frameset *frameset, dove_eye::Positset *truth,
+            dove_eye::Location *location, bool *has_location) override;
+
+  bool ObjectRadius(const dove_eye::CameraIndex cam,
+                    double *radius) const override;
+
+ private:
+  typedef std::vector<dove_eye::Frame::Timestamp> TimestampVector;
+
+  const dove_eye::Parameters &parameters_;
+  const std::string scenario_;
+  std::shared_ptr<const dove_eye::SyntheticScene> scene_;
+
+  std::unique_ptr<dove_eye::Aggregator> aggregator_;
+  dove_eye::Aggregator::Iterator it_;
+
+  /** Scene time of the frames in the last frameset */
+  TimestampVector scene_times_;
+};
+
+
+/** Video files with annotated posits
+ *
+ * Annotation is a text file with lines "frameset cam x y", frameset is
+ * zero-based number of the frameset as aggregated from the files, lines
+ * starting with '#' are ignored. Ground truth location is triangulated from
+ * annotated posits when calibration is given.
+ */
+class AnnotatedSequence : public Sequence {
+ public:
+  typedef std::vector<std::string> FilenameVector;
+
+  /**
+   * \param calibration_data  (optional) calibration of the cameras
+   */
+  AnnotatedSequence(const dove_eye::Parameters &parameters,
+                    const FilenameVector &videos,
+                    const std::string &annotation,
+                    const dove_eye::CalibrationData *calibration_data);
+
+  /** Whether annotation was read successfully */
+  inline bool IsValid() const {
+    return valid_;
+  }
+
+  std::string Name() const override {
+    return annotation_;
+  }
+
+  dove_eye::CameraIndex Arity() const override {
+    return videos_.size();
+  }
+
+  const dove_eye::CalibrationData *calibration_data() const override {
+    return calibration_data_;
+  }
+
+  void Rewind() override;
+
+  bool Next(dove_eye::Frameset *frameset, dove_eye::Positset *truth,
+            dove_eye::Location *location, bool *has_location) override;
+
+ private:
+  typedef std::map<size_t, dove_eye::Positset> AnnotationMap;
+
+  const dove_eye::Parameters &parameters_;
+  const FilenameVector videos_;
+  const std::string annotation_;
+  const dove_eye::CalibrationData *calibration_data_;
+
+  bool valid_;
+  AnnotationMap annotations_;
+
+  std::unique_ptr<dove_eye::Aggregator> aggregator_;
+  dove_eye::Aggregator::Iterator it_;
+  size_t frameset_no_;
+
+  bool ReadAnnotation();
+};
+
+} // namespace evaluate
+
+#endif // DOVE_EYE_EVALUATE_SEQUENCE_H_
@@ -0,0 +1,159 @@
+/** Latency test of the shared memory location ring
+ *
+ * Without -a, a LocationPublisher thread publishes synthetic records at
+ * given rate and the main thread reads them with the C reader library.
+ * With -a, it attaches to a running dove-eye instead.
+ *
+ * Reported latency is time from publishing to reading (CLOCK_MONOTONIC).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "dove_eye/frameset.h"
+#include "dove_eye/location_publisher.h"
+#include "dove_eye/positset.h"
+#include "location_reader.h"
+
+using dove_eye::Frameset;
+using dove_eye::LocationPublisher;
+using dove_eye::Location;
+using dove_eye::Positset;
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+namespace {
+
+const string kSelfTestName = "/dove_eye_latency_test";
+
+void Publish(const string &name, const double rate, const size_t count,
+             std::atomic<bool> *ready) {
+  LocationPublisher publisher(1);
+  if (!publisher.Open(name)) {
+    *ready = true;
+    return;
+  }
+  *ready = true;
+
+  Frameset frameset(1);
+  Positset positset(1);
+  Location location(1, 2, 3);
+  positset.SetValid(0);
+
+  /* Give reader time to open the ring */
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  const std::chrono::duration<double> period(1 / rate);
+  for (size_t i = 0; i < count; ++i) {
+    frameset.sequence_no = i;
+    publisher.Publish(frameset, positset, &location);
+    std::this_thread::sleep_for(period);
+  }
+
+  /* Let reader drain the ring before it's unlinked */
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+double Percentile(const vector<double> &sorted, const double p) {
+  size_t index = std::min(sorted.size() - 1,
+                          static_cast<size_t>(p * sorted.size()));
+  return sorted[index];
+}
+
+void PrintUsage(const string &name) {
+  cout << "Usage: " << name << " [-a] [-n count] [-r rate] [name]" << endl;
+  cout << "  -a  attach to running publisher (default self-test)" << endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  bool attach = false;
+  size_t count = 1000;
+  double rate = 100;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "an:r:h")) != -1) {
+    switch (opt) {
+      case 'a':
+        attach = true;
+        break;
+      case 'n':
+        count = std::stoul(optarg);
+        break;
+      case 'r':
+        rate = std::stod(optarg);
+        break;
+      default:
+        PrintUsage(argv[0]);
+        return 1;
+    }
+  }
+
+  string name = attach ? DOVE_EYE_RING_DEFAULT_NAME : kSelfTestName;
+  if (optind < argc) {
+    name = argv[optind];
+  }
+
+  std::thread publisher;
+  if (!attach) {
+    std::atomic<bool> ready(false);
+    publisher = std::thread(Publish, name, rate, count, &ready);
+    while (!ready) {
+      std::this_thread::yield();
+    }
+  }
+
+  dove_eye_reader reader;
+  if (dove_eye_reader_open(&reader, name.c_str()) != 0) {
+    std::cerr << "Cannot open ring '" << name << "'" << endl;
+    if (publisher.joinable()) {
+      publisher.join();
+    }
+    return 1;
+  }
+
+  vector<double> latencies;
+  latencies.reserve(count);
+
+  /* Busy polling, it's what a latency-sensitive consumer would do. */
+  dove_eye_ring_record record;
+  while (latencies.size() + reader.lost < count) {
+    if (dove_eye_reader_next(&reader, &record)) {
+      latencies.push_back(dove_eye_reader_now() - record.publish_time);
+    }
+  }
+
+  auto lost = reader.lost;
+  dove_eye_reader_close(&reader);
+  if (publisher.joinable()) {
+    publisher.join();
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  double sum = 0;
+  for (auto latency : latencies) {
+    sum += latency;
+  }
+
+  cout << "records: " << latencies.size() << ", lost: " << lost << endl;
+  if (!latencies.empty()) {
+    cout << "latency [us]: min " << latencies.front() * 1e6 <<
+        ", mean " << sum / latencies.size() * 1e6 <<
+        ", p50 " << Percentile(latencies, 0.5) * 1e6 <<
+        ", p99 " << Percentile(latencies, 0.99) * 1e6 <<
+        ", max " << latencies.back() * 1e6 << endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,141 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "location_reader.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+int dove_eye_reader_open(dove_eye_reader *reader, const char *name) {
+  struct stat st;
+  const struct dove_eye_ring_header *header;
+
+  memset(reader, 0, sizeof(*reader));
+  reader->fd = -1;
+
+  if (!name) {
+    name = DOVE_EYE_RING_DEFAULT_NAME;
+  }
+
+  reader->fd = shm_open(name, O_RDONLY, 0);
+  if (reader->fd < 0) {
+    return -1;
+  }
+
+  if (fstat(reader->fd, &st) != 0 ||
+      (size_t)st.st_size < sizeof(struct dove_eye_ring_header)) {
+    dove_eye_reader_close(reader);
+    return -1;
+  }
+
+  reader->map_size = st.st_size;
+  reader->map = mmap(NULL, reader->map_size, PROT_READ, MAP_SHARED,
+                     reader->fd, 0);
+  if (reader->map == MAP_FAILED) {
+    reader->map = NULL;
+    dove_eye_reader_close(reader);
+    return -1;
+  }
+
+  header = (const struct dove_eye_ring_header *)reader->map;
+  if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) !=
+          DOVE_EYE_RING_MAGIC ||
+      header->version != DOVE_EYE_RING_VERSION ||
+      header->slot_size != sizeof(struct dove_eye_ring_slot) ||
+      reader->map_size < sizeof(*header) +
+          header->capacity * sizeof(struct dove_eye_ring_slot)) {
+    dove_eye_reader_close(reader);
+    return -1;
+  }
+
+  reader->header = header;
+  reader->slots = (const struct dove_eye_ring_slot *)(header + 1);
+  /* Start with records published from now on */
+  reader->cursor = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+
+  return 0;
+}
+
+void dove_eye_reader_close(dove_eye_reader *reader) {
+  if (reader->map) {
+    munmap(reader->map, reader->map_size);
+  }
+  if (reader->fd >= 0) {
+    close(reader->fd);
+  }
+
+  memset(reader, 0, sizeof(*reader));
+  reader->fd = -1;
+}
+
+/** Seqlock read of record no, 0 when it was overwritten meanwhile */
+static int read_record(const dove_eye_reader *reader, uint64_t no,
+                       struct dove_eye_ring_record *record) {
+  const struct dove_eye_ring_slot *slot =
+      &reader->slots[no % reader->header->capacity];
+  uint64_t seq;
+
+  seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+  if (seq != 2 * no + 2) {
+    return 0;
+  }
+
+  memcpy(record, &slot->record, sizeof(*record));
+
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq;
+}
+
+int dove_eye_reader_next(dove_eye_reader *reader,
+                         struct dove_eye_ring_record *record) {
+  const uint64_t capacity = reader->header->capacity;
+  uint64_t head;
+
+  while (1) {
+    head = __atomic_load_n(&reader->header->head, __ATOMIC_ACQUIRE);
+    if (reader->cursor >= head) {
+      return 0;
+    }
+
+    /* Skip records that are certainly overwritten (keep one slot slack). */
+    if (head - reader->cursor >= capacity) {
+      reader->lost += head - reader->cursor - (capacity - 1);
+      reader->cursor = head - (capacity - 1);
+    }
+
+    if (read_record(reader, reader->cursor, record)) {
+      reader->cursor += 1;
+      return 1;
+    }
+
+    /* Overwritten while reading, publisher is ahead by a whole ring. */
+    reader->lost += 1;
+    reader->cursor += 1;
+  }
+}
+
+int dove_eye_reader_latest(dove_eye_reader *reader,
+                           struct dove_eye_ring_record *record) {
+  uint64_t head;
+
+  while (1) {
+    head = __atomic_load_n(&reader->header->head, __ATOMIC_ACQUIRE);
+    if (reader->cursor >= head) {
+      return 0;
+    }
+
+    if (read_record(reader, head - 1, record)) {
+      reader->cursor = head;
+      return 1;
+    }
+  }
+}
+
+double dove_eye_reader_now(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec * 1e-9;
+}
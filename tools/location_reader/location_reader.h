@@ -0,0 +1,62 @@
+#ifndef DOVE_EYE_LOCATION_READER_H_
+#define DOVE_EYE_LOCATION_READER_H_
+
+/*
+ * Minimal C library for reading tracking results published by dove-eye
+ * into shared memory (see dove_eye/location_ring.h).
+ *
+ * Readers never block the publisher. A slow reader loses records, the count
+ * of lost records is kept in dove_eye_reader.lost.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "dove_eye/location_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct dove_eye_reader {
+  int fd;
+  void *map;
+  size_t map_size;
+  const struct dove_eye_ring_header *header;
+  const struct dove_eye_ring_slot *slots;
+  /** No. of the next record to read */
+  uint64_t cursor;
+  /** No. of records overwritten before they were read */
+  uint64_t lost;
+} dove_eye_reader;
+
+/**
+ * \param name  name of shared memory object, NULL for the default
+ * \return 0 on success, -1 on error (publisher not running)
+ */
+int dove_eye_reader_open(dove_eye_reader *reader, const char *name);
+
+void dove_eye_reader_close(dove_eye_reader *reader);
+
+/** Read next record in order
+ *
+ * \return 1 when record was read, 0 when there's no new record
+ */
+int dove_eye_reader_next(dove_eye_reader *reader,
+                         struct dove_eye_ring_record *record);
+
+/** Read the most recent record, skip older unread ones (not counted lost)
+ *
+ * \return 1 when record was read, 0 when there's no new record
+ */
+int dove_eye_reader_latest(dove_eye_reader *reader,
+                           struct dove_eye_ring_record *record);
+
+/** Current CLOCK_MONOTONIC time [s], comparable with publish_time */
+double dove_eye_reader_now(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DOVE_EYE_LOCATION_READER_H_ */
@@ -0,0 +1,388 @@
+/** Deterministic replay of a recorded session through the tracker
+ *
+ * Recording (streams and pipeline log, see recording_format.h) is fed to
+ * Tracker and Localization frameset by frameset, with the same parameter
+ * changes and marks at the same framesets as in the live session. Output is
+ * one CSV line per frameset with tracking and localization time, so that
+ * latency spikes can be found and profiled offline.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <QString>
+#include <unistd.h>
+
+#include "common/trackers.h"
+#include "dove_eye/calibration_data.h"
+#include "dove_eye/frame_iterator.h"
+#include "dove_eye/frameset.h"
+#include "dove_eye/localization.h"
+#include "dove_eye/parameters.h"
+#include "dove_eye/recording_format.h"
+#include "dove_eye/recording_video_provider.h"
+#include "dove_eye/tracker.h"
+#include "io/calibration_data_storage.h"
+
+using dove_eye::CalibrationData;
+using dove_eye::CameraIndex;
+using dove_eye::FrameIterator;
+using dove_eye::Frameset;
+using dove_eye::InnerTracker;
+using dove_eye::Localization;
+using dove_eye::Location;
+using dove_eye::Parameters;
+using dove_eye::RecordingVideoProvider;
+using dove_eye::Tracker;
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/** Stream and log timestamps differ by rounding of the offset only */
+const double kTimestampTolerance = 1e-9;
+
+struct PendingMark {
+  size_t sequence_no;
+  CameraIndex cam;
+  bool project_other;
+  InnerTracker::Mark mark;
+};
+
+bool SetParameter(Parameters *parameters, const string &name,
+                  const double value) {
+  for (auto &parameter : *parameters) {
+    if (parameter.name == name) {
+      return parameters->Set(parameter.key, value);
+    }
+  }
+  return false;
+}
+
+double Milliseconds(const Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void PrintUsage(const string &name) {
+  cout << "Usage: " << name << " [-t tracker] [-c calibration] [-l] [-f]"
+      " basename" << endl;
+  cout << "  -t  inner tracker: template, histogram, circle, mosse, klt,"
+      " tld (default)" << endl;
+  cout << "  -c  calibration data (required by -l and -f)" << endl;
+  cout << "  -l  localization active" << endl;
+  cout << "  -f  fused tracking" << endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  string tracker_name = "tld";
+  string calibration_file;
+  bool localization_active = false;
+  bool fused = false;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "t:c:lfh")) != -1) {
+    switch (opt) {
+      case 't':
+        tracker_name = optarg;
+        break;
+      case 'c':
+        calibration_file = optarg;
+        break;
+      case 'l':
+        localization_active = true;
+        break;
+      case 'f':
+        fused = true;
+        break;
+      default:
+        PrintUsage(argv[0]);
+        return 1;
+    }
+  }
+
+  if (optind >= argc) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+  const string basename = argv[optind];
+
+  if ((localization_active || fused) && calibration_file.empty()) {
+    cerr << "Localization and fused tracking need calibration" << endl;
+    return 1;
+  }
+
+  const auto log_filename = dove_eye::recording::LogFilename(basename);
+  std::ifstream log(log_filename);
+  if (!log) {
+    cerr << "Cannot open '" << log_filename << "'" << endl;
+    return 1;
+  }
+
+  Parameters parameters;
+  auto inner_tracker = common::CreateTracker(parameters, tracker_name);
+  if (!inner_tracker) {
+    cerr << "Unknown tracker '" << tracker_name << "'" << endl;
+    return 1;
+  }
+
+  std::unique_ptr<CalibrationData> calibration_data;
+  if (!calibration_file.empty()) {
+    io::CalibrationDataStorage storage;
+    calibration_data.reset(new CalibrationData(
+            storage.LoadFromFile(QString::fromStdString(calibration_file))));
+  }
+
+  CameraIndex arity = 0;
+  vector<std::unique_ptr<RecordingVideoProvider>> providers;
+  vector<FrameIterator> iterators;
+  std::unique_ptr<Tracker> tracker;
+  std::unique_ptr<Localization> localization;
+
+  vector<PendingMark> marks;
+  bool tracking = false;
+  size_t drops = 0;
+
+  size_t framesets = 0;
+  size_t missing = 0;
+  vector<double> track_times;
+  double slowest_time = -1;
+  size_t slowest_sequence_no = 0;
+
+  cout << "sequence_no,capture_drops,track_ms,locate_ms,posits,located"
+      << endl;
+
+  string line;
+  size_t line_no = 0;
+  while (std::getline(log, line)) {
+    ++line_no;
+    std::istringstream input(line);
+    char type;
+    if (!(input >> type) || type == '#') {
+      continue;
+    }
+
+    bool valid = true;
+    switch (type) {
+      case 'A': {
+        valid = static_cast<bool>(input >> arity) && arity > 0 && !tracker;
+        if (!valid) {
+          break;
+        }
+        if (calibration_data && calibration_data->Arity() != arity) {
+          cerr << "Calibration doesn't match recording" << endl;
+          return 1;
+        }
+
+        for (CameraIndex cam = 0; cam < arity; ++cam) {
+          auto filename = dove_eye::recording::StreamFilename(basename, cam);
+          providers.emplace_back(new RecordingVideoProvider(filename));
+          iterators.push_back(providers.back()->begin());
+        }
+
+        tracker.reset(new Tracker(parameters, arity, *inner_tracker));
+        localization.reset(new Localization(arity));
+        if (calibration_data) {
+          tracker->calibration_data(calibration_data.get());
+          tracker->fused(fused);
+          localization->calibration_data(calibration_data.get());
+        }
+        break;
+      }
+
+      case 'P': {
+        size_t sequence_no;
+        string name;
+        double value;
+        valid = static_cast<bool>(input >> sequence_no >> name >> value);
+        if (valid && !SetParameter(&parameters, name, value)) {
+          cerr << "Ignoring parameter '" << name << "'" << endl;
+        }
+        break;
+      }
+
+      case 'D': {
+        CameraIndex cam;
+        size_t count;
+        valid = static_cast<bool>(input >> cam >> count);
+        drops += count;
+        break;
+      }
+
+      case 'M': {
+        PendingMark pending{0, 0, false,
+                            InnerTracker::Mark(InnerTracker::Mark::kInvalid)};
+        int project_other;
+        int mark_type;
+        auto &mark = pending.mark;
+        valid = static_cast<bool>(input >> pending.sequence_no >> pending.cam >>
+                                  project_other >> mark_type >>
+                                  mark.center.x >> mark.center.y >>
+                                  mark.radius >>
+                                  mark.top_left.x >> mark.top_left.y >>
+                                  mark.size.x >> mark.size.y);
+        pending.project_other = project_other;
+        mark.type = static_cast<InnerTracker::Mark::Type>(mark_type);
+        valid = valid && pending.cam < arity;
+        if (valid) {
+          marks.push_back(pending);
+        }
+        break;
+      }
+
+      case 'F': {
+        size_t sequence_no;
+        int written;
+        valid = tracker && static_cast<bool>(input >> sequence_no >> written);
+        if (!valid) {
+          break;
+        }
+
+        Frameset frameset(arity, sequence_no);
+        for (CameraIndex cam = 0; valid && cam < arity; ++cam) {
+          string timestamp;
+          valid = static_cast<bool>(input >> timestamp);
+          if (!valid || timestamp == "-" || !written) {
+            continue;
+          }
+
+          auto end = providers[cam]->end();
+          if (iterators[cam] == end) {
+            cerr << "Stream of camera " << cam << " ended early" << endl;
+            return 1;
+          }
+          auto &frame = frameset.Emplace(cam, *iterators[cam]);
+          ++iterators[cam];
+
+          /*
+           * Stream stores capture time (see Recorder::Record), the frame must
+           * be the logged one, otherwise replay isn't the session.
+           */
+          const auto logged = std::stod(timestamp);
+          const auto captured = logged +
+              parameters.Get(Parameters::CAM_OFFSET, cam);
+          if (frame.data.empty() ||
+              std::abs(frame.timestamp - captured) > kTimestampTolerance) {
+            cerr << "Frame of camera " << cam << " in frameset " <<
+                sequence_no << " doesn't match the log" << endl;
+            return 1;
+          }
+
+          /* Timestamp as seen by the tracker in the live session */
+          frame.timestamp = logged;
+        }
+
+        if (!valid) {
+          break;
+        }
+
+        ++framesets;
+        if (!written) {
+          /* Frames aren't in streams, replay diverges from the session here */
+          cout << sequence_no << "," << drops << ",,,," << endl;
+          ++missing;
+          drops = 0;
+          break;
+        }
+
+        /* Like Controller::SetMark() */
+        for (auto &pending : marks) {
+          if (pending.sequence_no != sequence_no) {
+            continue;
+          }
+          const auto &positset = tracker->SetMark(frameset, pending.cam,
+                                                  pending.mark,
+                                                  pending.project_other);
+          tracking = tracking || positset.ValidCount() > 0;
+
+          Location location;
+          if (localization_active && !tracker->fused() &&
+              localization->Locate(positset, &location)) {
+            tracker->SetLocation(location);
+          }
+        }
+        marks.erase(std::remove_if(marks.begin(), marks.end(),
+                                   [&](const PendingMark &pending) {
+                                     return pending.sequence_no <= sequence_no;
+                                   }),
+                    marks.end());
+
+        if (!tracking) {
+          cout << sequence_no << "," << drops << ",,,," << endl;
+          drops = 0;
+          break;
+        }
+
+        const auto start = Clock::now();
+        const auto &positset = tracker->Track(frameset);
+        const auto tracked = Clock::now();
+
+        Location location;
+        bool located = false;
+        if (localization_active) {
+          located = localization->Locate(positset, &location);
+          if (located && !tracker->fused()) {
+            tracker->SetLocation(location);
+          }
+        }
+        const auto finished = Clock::now();
+
+        const auto track_time = Milliseconds(tracked - start);
+        if (track_time > slowest_time) {
+          slowest_time = track_time;
+          slowest_sequence_no = sequence_no;
+        }
+        track_times.push_back(track_time);
+
+        cout << sequence_no << "," << drops << "," <<
+            track_times.back() << "," << Milliseconds(finished - tracked) <<
+            "," << positset.ValidCount() << "," << located << endl;
+        drops = 0;
+        break;
+      }
+
+      default:
+        valid = false;
+        break;
+    }
+
+    if (!valid) {
+      cerr << "Invalid line " << line_no << " of '" << log_filename << "'"
+          << endl;
+      return 1;
+    }
+  }
+
+  cerr << "framesets: " << framesets << ", missing in streams: " << missing
+      << ", tracked: " << track_times.size() << endl;
+  if (!track_times.empty()) {
+    auto sorted = track_times;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (auto time : sorted) {
+      sum += time;
+    }
+    const auto p99 = sorted[std::min(sorted.size() - 1,
+                                     static_cast<size_t>(0.99 * sorted.size()))];
+
+    cerr << "track [ms]: mean " << sum / sorted.size() << ", p99 " << p99 <<
+        ", max " << sorted.back() << " (frameset " << slowest_sequence_no <<
+        ")" << endl;
+  }
+
+  return 0;
+}